@@ -0,0 +1,149 @@
+/********************************************//**
+ * \file stream_benchmark.cpp
+ * \brief Measures yei_threespace.hpp against the raw C API calls it wraps.
+ *
+ * Each case runs the same work through the raw tss_* functions and through the wrapper, and prints
+ * nanoseconds per call for both.
+ *
+ *  stream_benchmark COM3     uses a real sensor: typed getter, and decoding streamed packets.
+ *  stream_benchmark          when built with -DYEI_BENCHMARK_STUB: the tss_* functions are local stubs,
+ *                            so only the cost of the wrapper itself is measured.
+ *
+ *  cl /O2 /EHsc /I..\YEISensorLib stream_benchmark.cpp ..\YEISensorLib\ThreeSpace_API.lib
+ *  cl /O2 /EHsc /DYEI_BENCHMARK_STUB /DTSS_STATIC_LIB /I..\YEISensorLib stream_benchmark.cpp
+ ***********************************************/
+#include <stdio.h>
+#include <chrono>
+#include "yei_threespace.hpp"
+
+typedef yei::stream_session<TSS_GET_TARED_ORIENTATION_AS_QUATERNION,
+                            TSS_GET_ALL_CORRECTED_COMPONENT_SENSOR_DATA,
+                            TSS_GET_BUTTON_STATE> session_type;
+
+#ifdef YEI_BENCHMARK_STUB
+//Stand-ins for the DLL, kept out of line like the real calls.
+#if defined(_MSC_VER)
+#define YEI_NOINLINE __declspec(noinline)
+#else
+#define YEI_NOINLINE __attribute__((noinline))
+#endif
+
+static volatile float stub_value = 1.0f;
+
+extern "C" {
+YEI_NOINLINE TSS_Device_Id tss_createTSDeviceStr(const char*, TSS_Timestamp_Mode) { return 0x04000001; }
+YEI_NOINLINE TSS_Error tss_closeTSDevice(TSS_Device_Id) { return TSS_NO_ERROR; }
+YEI_NOINLINE TSS_Error tss_setStreamingSlots(TSS_Device_Id, const TSS_Stream_Command*, unsigned int*) { return TSS_NO_ERROR; }
+YEI_NOINLINE TSS_Error tss_setStreamingTiming(TSS_Device_Id, unsigned int, unsigned int, unsigned int, unsigned int*) { return TSS_NO_ERROR; }
+YEI_NOINLINE TSS_Error tss_startStreaming(TSS_Device_Id, unsigned int*) { return TSS_NO_ERROR; }
+YEI_NOINLINE TSS_Error tss_stopStreaming(TSS_Device_Id, unsigned int*) { return TSS_NO_ERROR; }
+YEI_NOINLINE TSS_Error tss_getTaredOrientationAsQuaternion(TSS_Device_Id, float* quat4, unsigned int* timestamp)
+{
+    quat4[0] = quat4[1] = quat4[2] = 0;
+    quat4[3] = stub_value;
+    if (timestamp) *timestamp = 1;
+    return TSS_NO_ERROR;
+}
+YEI_NOINLINE TSS_Error tss_getLastStreamData(TSS_Device_Id, char* output_data, unsigned int output_data_len, unsigned int* timestamp)
+{
+    for (unsigned int i = 0; i < output_data_len; ++i) output_data[i] = static_cast<char>(i);
+    if (timestamp) *timestamp = 1;
+    return TSS_NO_ERROR;
+}
+}
+#endif
+
+template<typename F>
+static double nanoseconds_per_call(int iterations, F f)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) f();
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void report(const char* name, double raw, double wrapped)
+{
+    printf("%-28s raw %10.1f ns   wrapped %10.1f ns   overhead %+6.1f%%\n", name, raw, wrapped, (wrapped - raw) * 100.0 / raw);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef YEI_BENCHMARK_STUB
+    const char* port = "stub";
+    const int getter_iterations = 20000000;
+    const int stream_iterations = 20000000;
+#else
+    if (argc < 2)
+    {
+        printf("usage: stream_benchmark <com port>\n");
+        return 1;
+    }
+    const char* port = argv[1];
+    const int getter_iterations = 2000;
+    const int stream_iterations = 1000000;
+#endif
+    (void)argc;
+    (void)argv;
+
+    yei::device dev = yei::device::open(port);
+    if (!dev.is_open())
+    {
+        printf("could not open %s\n", port);
+        return 1;
+    }
+
+    float sink = 0;
+
+    //Typed getter against the raw call.
+    for (int round = 0; round < 2; ++round)
+    {
+        double raw = nanoseconds_per_call(getter_iterations, [&]()
+        {
+            float quat[4];
+            unsigned int timestamp;
+            if (tss_getTaredOrientationAsQuaternion(dev.id(), quat, &timestamp) == TSS_NO_ERROR) sink += quat[3];
+        });
+        double wrapped = nanoseconds_per_call(getter_iterations, [&]()
+        {
+            yei::reading<yei::values<float, 4> > quat = dev.get<TSS_GET_TARED_ORIENTATION_AS_QUATERNION>();
+            if (quat.ok()) sink += quat.value[3];
+        });
+        //The first round warms up caches and the link.
+        if (round == 1) report("get quaternion", raw, wrapped);
+    }
+
+    //Reading and decoding a streamed packet: hand computed offsets against the typed frame.
+    session_type session(dev, 0);
+    if (!session.ok())
+    {
+        printf("streaming failed: %s\n", TSS_Error_String[session.error()]);
+        return 1;
+    }
+    for (int round = 0; round < 2; ++round)
+    {
+        double raw = nanoseconds_per_call(stream_iterations, [&]()
+        {
+            char packet[16 + 36 + 1];
+            unsigned int timestamp;
+            if (tss_getLastStreamData(dev.id(), packet, sizeof(packet), &timestamp) != TSS_NO_ERROR) return;
+            float quat[4];
+            float accel[3];
+            memcpy(quat, packet, sizeof(quat));
+            memcpy(accel, packet + 16 + 12, sizeof(accel));
+            sink += quat[3] + accel[1] + packet[16 + 36];
+        });
+        double wrapped = nanoseconds_per_call(stream_iterations, [&]()
+        {
+            session_type::frame frame;
+            if (session.poll(frame) != TSS_NO_ERROR) return;
+            yei::values<float, 4> quat = frame.get<0>();
+            yei::values<float, 9> components = frame.get<1>();
+            sink += quat[3] + components[4] + frame.get<2>()[0];
+        });
+        if (round == 1) report("poll and decode packet", raw, wrapped);
+    }
+
+    printf("(checksum %f)\n", sink);
+    return 0;
+}
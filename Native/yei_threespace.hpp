@@ -0,0 +1,407 @@
+/********************************************//**
+ * \file yei_threespace.hpp
+ * \brief Header-only C++ client over the YEI 3-Space C API (yei_threespace_api.h).
+ *
+ * - yei::device owns a TSS_Device_Id and closes it with tss_closeTSDevice, it can be moved but not copied.
+ * - device.get<TSS_GET_...>() calls the matching tss_get* function and returns the value by value,
+ *   in a fixed-size yei::values<T, N>, together with its timestamp and error code.
+ * - yei::stream_session<Slots...> sets the streaming slots, timing and starts streaming, and stops on destruction.
+ *   Its frames know the packet layout at compile time, so reading slot I is one memcpy from a constant offset.
+ * - Buffer APIs take a yei::span (pointer + count), nothing is allocated.
+ *
+ * Everything is inline and free of exceptions and virtual calls, a getter compiles to the raw tss_* call.
+ * Native/stream_benchmark.cpp measures it against the raw calls.
+ *
+ * Add YEISensorLib to the include path and link ThreeSpace_API.lib. Needs C++11 variadic templates (Visual Studio 2013, gcc 4.7 or later).
+ ***********************************************/
+#ifndef YEI_THREESPACE_HPP_INCLUDED
+#define YEI_THREESPACE_HPP_INCLUDED
+
+#include <stddef.h>
+#include <string.h>
+#include "yei_threespace_api.h"
+
+namespace yei
+{
+
+/********************************************//**
+ * Fixed-size value returned by a getter, laid out exactly as the C API writes it.
+ ***********************************************/
+template<typename T, size_t N>
+struct values
+{
+    T v[N];
+
+    T& operator[](size_t i) { return v[i]; }
+    const T& operator[](size_t i) const { return v[i]; }
+    T* data() { return v; }
+    const T* data() const { return v; }
+    static size_t size() { return N; }
+};
+
+/********************************************//**
+ * A value read from a 3-Space device, with the timestamp and error code of the call.
+ ***********************************************/
+template<typename T>
+struct reading
+{
+    T value;
+    unsigned int timestamp;
+    TSS_Error error;
+
+    bool ok() const { return error == TSS_NO_ERROR; }
+};
+
+/********************************************//**
+ * Non-owning view of a contiguous buffer.
+ ***********************************************/
+template<typename T>
+class span
+{
+public:
+    span() : data_(0), size_(0) {}
+    span(T* data, size_t size) : data_(data), size_(size) {}
+    template<size_t N>
+    span(T (&array)[N]) : data_(array), size_(N) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t size_bytes() const { return size_ * sizeof(T); }
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+/********************************************//**
+ * \brief Compile time description of a streamable command.
+ *
+ * value_type is what the command returns, stream_size the bytes it takes in a stream packet,
+ * read calls the matching tss_get* function.
+ ***********************************************/
+template<TSS_Stream_Command_Enum Command>
+struct command_traits;
+
+#define YEI_COMMAND(command, type, count, function)                                                     \
+    template<> struct command_traits<command>                                                           \
+    {                                                                                                   \
+        typedef values<type, count> value_type;                                                         \
+        static const size_t stream_size = sizeof(type) * count;                                         \
+        static TSS_Error read(TSS_Device_Id id, value_type& value, unsigned int* timestamp)            \
+        {                                                                                               \
+            return function(id, value.v, timestamp);                                                    \
+        }                                                                                               \
+    };
+
+#define YEI_COMMAND2(command, count, function)                                                          \
+    template<> struct command_traits<command>                                                           \
+    {                                                                                                   \
+        typedef values<float, count> value_type;                                                        \
+        static const size_t stream_size = sizeof(float) * count;                                        \
+        static TSS_Error read(TSS_Device_Id id, value_type& value, unsigned int* timestamp)            \
+        {                                                                                               \
+            return function(id, value.v, value.v + 3, timestamp);                                      \
+        }                                                                                               \
+    };
+
+#define YEI_COMMAND3(command, function)                                                                 \
+    template<> struct command_traits<command>                                                           \
+    {                                                                                                   \
+        typedef values<float, 9> value_type;                                                            \
+        static const size_t stream_size = sizeof(float) * 9;                                            \
+        static TSS_Error read(TSS_Device_Id id, value_type& value, unsigned int* timestamp)            \
+        {                                                                                               \
+            return function(id, value.v, value.v + 3, value.v + 6, timestamp);                         \
+        }                                                                                               \
+    };
+
+YEI_COMMAND(TSS_GET_TARED_ORIENTATION_AS_QUATERNION, float, 4, tss_getTaredOrientationAsQuaternion)
+YEI_COMMAND(TSS_GET_TARED_ORIENTATION_AS_EULER_ANGLES, float, 3, tss_getTaredOrientationAsEulerAngles)
+YEI_COMMAND(TSS_GET_TARED_ORIENTATION_AS_ROTATION_MATRIX, float, 9, tss_getTaredOrientationAsRotationMatrix)
+YEI_COMMAND(TSS_GET_TARED_ORIENTATION_AS_AXIS_ANGLE, float, 4, tss_getTaredOrientationAsAxisAngle)
+YEI_COMMAND2(TSS_GET_TARED_ORIENTATION_AS_TWO_VECTOR, 6, tss_getTaredOrientationAsTwoVector)
+YEI_COMMAND(TSS_GET_DIFFERENCE_QUATERNION, float, 4, tss_getDifferenceQuaternion)
+YEI_COMMAND(TSS_GET_UNTARED_ORIENTATION_AS_QUATERNION, float, 4, tss_getUntaredOrientationAsQuaternion)
+YEI_COMMAND(TSS_GET_UNTARED_ORIENTATION_AS_EULER_ANGLES, float, 3, tss_getUntaredOrientationAsEulerAngles)
+YEI_COMMAND(TSS_GET_UNTARED_ORIENTATION_AS_ROTATION_MATRIX, float, 9, tss_getUntaredOrientationAsRotationMatrix)
+YEI_COMMAND(TSS_GET_UNTARED_ORIENTATION_AS_AXIS_ANGLE, float, 4, tss_getUntaredOrientationAsAxisAngle)
+YEI_COMMAND2(TSS_GET_UNTARED_ORIENTATION_AS_TWO_VECTOR, 6, tss_getUntaredOrientationAsTwoVector)
+YEI_COMMAND2(TSS_GET_TARED_TWO_VECTOR_IN_SENSOR_FRAME, 6, tss_getTaredTwoVectorInSensorFrame)
+YEI_COMMAND2(TSS_GET_UNTARED_TWO_VECTOR_IN_SENSOR_FRAME, 6, tss_getUntaredTwoVectorInSensorFrame)
+YEI_COMMAND3(TSS_GET_ALL_NORMALIZED_COMPONENT_SENSOR_DATA, tss_getAllNormalizedComponentSensorData)
+YEI_COMMAND(TSS_GET_NORMALIZED_GYRO_RATE, float, 3, tss_getNormalizedGyroRate)
+YEI_COMMAND(TSS_GET_NORMALIZED_ACCELEROMETER_VECTOR, float, 3, tss_getNormalizedAccelerometerVector)
+YEI_COMMAND(TSS_GET_NORMALIZED_COMPASS_VECTOR, float, 3, tss_getNormalizedCompassVector)
+YEI_COMMAND3(TSS_GET_ALL_CORRECTED_COMPONENT_SENSOR_DATA, tss_getAllCorrectedComponentSensorData)
+YEI_COMMAND(TSS_GET_CORRECTED_GYRO_RATE, float, 3, tss_getCorrectedGyroRate)
+YEI_COMMAND(TSS_GET_CORRECTED_ACCELEROMETER_VECTOR, float, 3, tss_getCorrectedAccelerometerVector)
+YEI_COMMAND(TSS_GET_CORRECTED_COMPASS_VECTOR, float, 3, tss_getCorrectedCompassVector)
+YEI_COMMAND(TSS_GET_CORRECTED_LINEAR_ACCELERATION_IN_GLOBAL_SPACE, float, 3, tss_getCorrectedLinearAccelerationInGlobalSpace)
+YEI_COMMAND(TSS_GET_TEMPERATURE_C, float, 1, tss_getTemperatureC)
+YEI_COMMAND(TSS_GET_TEMPERATURE_F, float, 1, tss_getTemperatureF)
+YEI_COMMAND(TSS_GET_CONFIDENCE_FACTOR, float, 1, tss_getConfidenceFactor)
+YEI_COMMAND3(TSS_GET_ALL_RAW_COMPONENT_SENSOR_DATA, tss_getAllRawComponentSensorData)
+YEI_COMMAND(TSS_GET_RAW_GYROSCOPE_RATE, float, 3, tss_getRawGyroscopeRate)
+YEI_COMMAND(TSS_GET_RAW_ACCELEROMETER_DATA, float, 3, tss_getRawAccelerometerData)
+YEI_COMMAND(TSS_GET_RAW_COMPASS_DATA, float, 3, tss_getRawCompassData)
+YEI_COMMAND(TSS_GET_BATTERY_VOLTAGE, float, 1, tss_getBatteryVoltage)
+YEI_COMMAND(TSS_GET_BATTERY_PERCENT_REMAINING, unsigned char, 1, tss_getBatteryPercentRemaining)
+YEI_COMMAND(TSS_GET_BATTERY_STATUS, unsigned char, 1, tss_getBatteryStatus)
+YEI_COMMAND(TSS_GET_BUTTON_STATE, unsigned char, 1, tss_getButtonState)
+
+#undef YEI_COMMAND
+#undef YEI_COMMAND2
+#undef YEI_COMMAND3
+
+namespace detail
+{
+    template<TSS_Stream_Command_Enum... Slots>
+    struct layout;
+
+    template<>
+    struct layout<>
+    {
+        static const size_t size = 0;
+        static const size_t count = 0;
+    };
+
+    template<TSS_Stream_Command_Enum First, TSS_Stream_Command_Enum... Rest>
+    struct layout<First, Rest...>
+    {
+        static const size_t size = command_traits<First>::stream_size + layout<Rest...>::size;
+        static const size_t count = 1 + sizeof...(Rest);
+    };
+
+    /** Command and byte offset of slot I. */
+    template<size_t I, TSS_Stream_Command_Enum... Slots>
+    struct slot;
+
+    template<TSS_Stream_Command_Enum First, TSS_Stream_Command_Enum... Rest>
+    struct slot<0, First, Rest...>
+    {
+        static const TSS_Stream_Command_Enum command = First;
+        static const size_t offset = 0;
+    };
+
+    template<size_t I, TSS_Stream_Command_Enum First, TSS_Stream_Command_Enum... Rest>
+    struct slot<I, First, Rest...>
+    {
+        static const TSS_Stream_Command_Enum command = slot<I - 1, Rest...>::command;
+        static const size_t offset = command_traits<First>::stream_size + slot<I - 1, Rest...>::offset;
+    };
+}
+
+/********************************************//**
+ * \brief One stream packet of a stream_session, decoded on access.
+ *
+ * get<I>() returns slot I, as the getter of the same command would.
+ ***********************************************/
+template<TSS_Stream_Command_Enum... Slots>
+struct stream_frame
+{
+    static const size_t size = detail::layout<Slots...>::size;
+
+    char data[size];
+    unsigned int timestamp;
+
+    template<size_t I>
+    typename command_traits<detail::slot<I, Slots...>::command>::value_type get() const
+    {
+        typename command_traits<detail::slot<I, Slots...>::command>::value_type value;
+        memcpy(value.v, data + detail::slot<I, Slots...>::offset, sizeof(value.v));
+        return value;
+    }
+};
+
+/********************************************//**
+ * \brief Owns a 3-Space device ID, closing it with tss_closeTSDevice.
+ *
+ * Move only: a moved-from device holds TSS_NO_DEVICE_ID and closes nothing.
+ ***********************************************/
+class device
+{
+public:
+    device() : id_(TSS_NO_DEVICE_ID) {}
+    explicit device(TSS_Device_Id id) : id_(id) {}
+
+    device(device&& other) : id_(other.release()) {}
+
+    device& operator=(device&& other)
+    {
+        if (this != &other) reset(other.release());
+        return *this;
+    }
+
+    ~device() { reset(); }
+
+    /** Opens the 3-Space device on a com port, check is_open(). */
+    static device open(const char* com_port, TSS_Timestamp_Mode mode = TSS_TIMESTAMP_SENSOR)
+    {
+        return device(tss_createTSDeviceStr(com_port, mode));
+    }
+
+    /** Opens the wireless sensor paired with a dongle at a logical ID (0-14), check is_open(). */
+    static device from_dongle(const device& dongle, int logical_id)
+    {
+        unsigned int id = TSS_NO_DEVICE_ID;
+        if (tss_getSensorFromDongle(dongle.id_, logical_id, &id) != TSS_NO_ERROR) id = TSS_NO_DEVICE_ID;
+        return device(id);
+    }
+
+    TSS_Device_Id id() const { return id_; }
+
+    bool is_open() const { return id_ != TSS_NO_DEVICE_ID; }
+
+    /** Gives up ownership without closing. */
+    TSS_Device_Id release()
+    {
+        TSS_Device_Id id = id_;
+        id_ = TSS_NO_DEVICE_ID;
+        return id;
+    }
+
+    void reset(TSS_Device_Id id = TSS_NO_DEVICE_ID)
+    {
+        if (id_ != TSS_NO_DEVICE_ID) tss_closeTSDevice(id_);
+        id_ = id;
+    }
+
+    /** Reads a streamable command directly, e.g. get<TSS_GET_TARED_ORIENTATION_AS_QUATERNION>(). */
+    template<TSS_Stream_Command_Enum Command>
+    reading<typename command_traits<Command>::value_type> get() const
+    {
+        reading<typename command_traits<Command>::value_type> result;
+        result.error = command_traits<Command>::read(id_, result.value, &result.timestamp);
+        return result;
+    }
+
+    /** Same as get, into an existing value. */
+    template<TSS_Stream_Command_Enum Command>
+    TSS_Error read(typename command_traits<Command>::value_type& value, unsigned int& timestamp) const
+    {
+        return command_traits<Command>::read(id_, value, &timestamp);
+    }
+
+    TSS_Error tare()
+    {
+        return tss_tareWithCurrentOrientation(id_, NULL);
+    }
+
+    TSS_Error set_led_color(float r, float g, float b)
+    {
+        const float color[3] = { r, g, b };
+        return tss_setLEDColor(id_, color, NULL);
+    }
+
+    /** Sets up to 8 streaming slots, the rest are TSS_NULL. */
+    template<TSS_Stream_Command_Enum... Slots>
+    TSS_Error set_streaming_slots()
+    {
+        static_assert(sizeof...(Slots) <= 8, "A 3-Space device has 8 streaming slots");
+        //One extra TSS_NULL so an empty pack still makes a valid array.
+        const TSS_Stream_Command slots[sizeof...(Slots) + 1] = { static_cast<TSS_Stream_Command>(Slots)..., TSS_NULL };
+        TSS_Stream_Command slots8[8];
+        for (size_t i = 0; i < 8; ++i) slots8[i] = i < sizeof...(Slots) ? slots[i] : static_cast<TSS_Stream_Command>(TSS_NULL);
+        return tss_setStreamingSlots(id_, slots8, NULL);
+    }
+
+    /** Reads all streaming slots with one command (tss_getStreamingBatch), without streaming. */
+    template<TSS_Stream_Command_Enum... Slots>
+    TSS_Error read_batch(stream_frame<Slots...>& frame) const
+    {
+        return tss_getStreamingBatch(id_, frame.data, stream_frame<Slots...>::size, &frame.timestamp);
+    }
+
+    /** Copies the last stream packet without waiting, into a buffer of the packet's size. */
+    TSS_Error last_stream_data(span<char> buffer, unsigned int& timestamp) const
+    {
+        return tss_getLastStreamData(id_, buffer.data(), static_cast<unsigned int>(buffer.size()), &timestamp);
+    }
+
+    /** Waits up to timeout_ms for the next stream packet. */
+    TSS_Error latest_stream_data(span<char> buffer, unsigned int timeout_ms, unsigned int& timestamp) const
+    {
+        return tss_getLatestStreamData(id_, buffer.data(), static_cast<unsigned int>(buffer.size()), timeout_ms, &timestamp);
+    }
+
+private:
+    device(const device&);
+    device& operator=(const device&);
+
+    TSS_Device_Id id_;
+};
+
+/********************************************//**
+ * \brief Streams the given slots from a device for its lifetime.
+ *
+ *  yei::stream_session<TSS_GET_TARED_ORIENTATION_AS_QUATERNION, TSS_GET_BUTTON_STATE> session(dev, 5000);
+ *  yei::stream_session<...>::frame frame;
+ *  if (session.ok() && session.wait(frame, 100) == TSS_NO_ERROR) { quaternion = frame.get<0>(); }
+ ***********************************************/
+template<TSS_Stream_Command_Enum... Slots>
+class stream_session
+{
+public:
+    typedef stream_frame<Slots...> frame;
+
+    /**
+     * \param interval_us Microseconds between packets, 0 for as fast as possible.
+     * \param duration_us How long to stream, TSS_INFINITE_DURATION until the session ends.
+     */
+    stream_session(device& dev, unsigned int interval_us, unsigned int duration_us = TSS_INFINITE_DURATION)
+        : device_(dev.id())
+    {
+        error_ = dev.set_streaming_slots<Slots...>();
+        if (error_ == TSS_NO_ERROR) error_ = tss_setStreamingTiming(device_, interval_us, duration_us, 0, NULL);
+        if (error_ == TSS_NO_ERROR) error_ = tss_startStreaming(device_, NULL);
+        started_ = error_ == TSS_NO_ERROR;
+    }
+
+    ~stream_session()
+    {
+        if (started_) tss_stopStreaming(device_, NULL);
+    }
+
+    bool ok() const { return started_; }
+
+    /** Why the session did not start. */
+    TSS_Error error() const { return error_; }
+
+    /** The last packet, without waiting. */
+    TSS_Error poll(frame& out) const
+    {
+        return tss_getLastStreamData(device_, out.data, frame::size, &out.timestamp);
+    }
+
+    /** Waits up to timeout_ms for the next packet. */
+    TSS_Error wait(frame& out, unsigned int timeout_ms) const
+    {
+        return tss_getLatestStreamData(device_, out.data, frame::size, timeout_ms, &out.timestamp);
+    }
+
+    /**
+     * Fills frames with consecutive packets, waiting up to timeout_ms for each.
+     * \return How many frames were filled before an error or timeout.
+     */
+    size_t wait(span<frame> frames, unsigned int timeout_ms) const
+    {
+        size_t count = 0;
+        while (count < frames.size() && wait(frames[count], timeout_ms) == TSS_NO_ERROR) ++count;
+        return count;
+    }
+
+private:
+    stream_session(const stream_session&);
+    stream_session& operator=(const stream_session&);
+
+    TSS_Device_Id device_;
+    TSS_Error error_;
+    bool started_;
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Recording;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensor.ConsoleTest
+{
+    /// <summary>
+    /// Compression ratio and throughput of the compressed session log codec.
+    /// Usage: YEISensor.ConsoleTest codec-benchmark [session.ysl]
+    /// Without a session log a 100Hz, 10 minute session is simulated.
+    /// </summary>
+    static class CodecBenchmark
+    {
+        public static void Run(string sessionPath)
+        {
+            SessionLogHeader header;
+            byte[] records;
+            if (sessionPath != null)
+            {
+                using (var reader = new SessionLogReader(sessionPath))
+                {
+                    if (!reader.IsValid)
+                    {
+                        Console.WriteLine("Not a session log: {0}", sessionPath);
+                        return;
+                    }
+                    header = reader.Header;
+                    records = new byte[reader.RecordCount * header.RecordSize];
+                    reader.ReadRecords(records);
+                }
+            }
+            else
+            {
+                header = new SessionLogHeader(0x12345678, new StreamSlotLayout(StreamCommandEnum.TaredOrientationAsQuaternion,
+                                                                                StreamCommandEnum.AllNormalizedComponentSensorData,
+                                                                                StreamCommandEnum.ButtonState));
+                records = Simulate(header, 60000);
+            }
+
+            var count = records.Length / header.RecordSize;
+            Console.WriteLine("{0} records of {1} bytes, {2:0.0} MB", count, header.RecordSize, records.Length / 1048576.0);
+            Console.WriteLine("{0,-28} {1,8} {2,12} {3,12} {4,12}", "Codec", "Ratio", "Encode MB/s", "Decode MB/s", "Max q error");
+
+            Measure("lossless", header, records, new StreamLogCodecOptions());
+            Measure("q 1e-3", header, records, new StreamLogCodecOptions { QuaternionErrorBound = 1e-3f });
+            Measure("q 1e-4, components 1e-4", header, records, new StreamLogCodecOptions { QuaternionErrorBound = 1e-4f, ComponentResolution = 1e-4f });
+            Measure("q 1e-3, components 1e-3", header, records, new StreamLogCodecOptions { QuaternionErrorBound = 1e-3f, ComponentResolution = 1e-3f });
+        }
+
+        private static void Measure(string name, SessionLogHeader header, byte[] records, StreamLogCodecOptions options)
+        {
+            const int rounds = 5;
+            var count = records.Length / header.RecordSize;
+            byte[] compressed = null;
+
+            //Round -1 warms up the JIT
+            var watch = new Stopwatch();
+            for (var round = -1; round < rounds; round++)
+            {
+                if (round == 0) watch.Start();
+                var memory = new MemoryStream();
+                using (var writer = new CompressedSessionLogWriter(memory, header, options))
+                {
+                    writer.WriteRecords(records, 0, count);
+                }
+                compressed = memory.ToArray();
+            }
+            var encodeSeconds = watch.Elapsed.TotalSeconds / rounds;
+
+            var decoded = new byte[records.Length];
+            watch.Reset();
+            for (var round = -1; round < rounds; round++)
+            {
+                if (round == 0) watch.Start();
+                using (var reader = new CompressedSessionLogReader(new MemoryStream(compressed)))
+                {
+                    reader.ReadRecords(decoded);
+                }
+            }
+            var decodeSeconds = watch.Elapsed.TotalSeconds / rounds;
+
+            var quaternion = header.Layout.OffsetOf(StreamCommandEnum.TaredOrientationAsQuaternion);
+            var maxError = 0.0;
+            for (var i = 0; quaternion >= 0 && i < count; i++)
+            {
+                var offset = i * header.RecordSize + 4 + quaternion;
+                var a = StreamSlotLayout.ReadQuaternion(records, offset);
+                var b = StreamSlotLayout.ReadQuaternion(decoded, offset);
+                var sign = a.X * b.X + a.Y * b.Y + a.Z * b.Z + a.W * b.W < 0 ? -1 : 1;
+                maxError = Math.Max(maxError, Math.Abs(a.X - sign * b.X));
+                maxError = Math.Max(maxError, Math.Abs(a.Y - sign * b.Y));
+                maxError = Math.Max(maxError, Math.Abs(a.Z - sign * b.Z));
+                maxError = Math.Max(maxError, Math.Abs(a.W - sign * b.W));
+            }
+
+            var megabytes = records.Length / 1048576.0;
+            Console.WriteLine("{0,-28} {1,8:0.00} {2,12:0} {3,12:0} {4,12:0.0e0}",
+                              name, (double)records.Length / compressed.Length, megabytes / encodeSeconds, megabytes / decodeSeconds, maxError);
+        }
+
+        /// <summary>
+        /// A slowly turning sensor with noisy component data and timestamps jittering around 10ms.
+        /// </summary>
+        private static byte[] Simulate(SessionLogHeader header, int count)
+        {
+            var random = new Random(1);
+            var records = new byte[count * header.RecordSize];
+            var quaternion = 4 + header.Layout.OffsetOf(StreamCommandEnum.TaredOrientationAsQuaternion);
+            var components = 4 + header.Layout.OffsetOf(StreamCommandEnum.AllNormalizedComponentSensorData);
+            var button = 4 + header.Layout.OffsetOf(StreamCommandEnum.ButtonState);
+            uint timeStamp = 0;
+
+            for (var i = 0; i < count; i++)
+            {
+                var offset = i * header.RecordSize;
+                timeStamp += (uint)(10000 + random.Next(-20, 21));
+                Write(records, offset, BitConverter.GetBytes(timeStamp));
+
+                var angle = i * 0.002;
+                var values = new[]
+                                 {
+                                     (float)(Math.Sin(angle / 2) * 0.6), (float)(Math.Sin(angle / 2) * 0.8), 0f, (float)Math.Cos(angle / 2),
+                                     Noise(random, 0.004), Noise(random, 0.004), (float)(0.002 * Math.Sin(angle)) + Noise(random, 0.004),
+                                     Noise(random, 0.01), Noise(random, 0.01), 1 + Noise(random, 0.01),
+                                     0.3f + Noise(random, 0.02), -0.1f + Noise(random, 0.02), 0.9f + Noise(random, 0.02),
+                                 };
+                for (var v = 0; v < 4; v++) Write(records, offset + quaternion + v * 4, BitConverter.GetBytes(values[v]));
+                for (var v = 0; v < 9; v++) Write(records, offset + components + v * 4, BitConverter.GetBytes(values[4 + v]));
+                records[offset + button] = (byte)(i % 3000 < 40 ? 1 : 0);
+            }
+            return records;
+        }
+
+        private static float Noise(Random random, double amplitude)
+        {
+            return (float)((random.NextDouble() * 2 - 1) * amplitude);
+        }
+
+        private static void Write(byte[] records, int offset, byte[] bytes)
+        {
+            Buffer.BlockCopy(bytes, 0, records, offset, bytes.Length);
+        }
+    }
+}
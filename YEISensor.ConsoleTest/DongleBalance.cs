@@ -0,0 +1,116 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped;
+using YEISensorLib.Sharped.Streaming;
+using YEISensorLib.Sharped.Wireless;
+
+namespace YEISensor.ConsoleTest
+{
+    /// <summary>
+    /// Measures the stream load of every dongle, plans an even spread and, with --apply, re-pairs the sensors and measures again.
+    /// Usage: YEISensor.ConsoleTest dongle-balance [seconds] [rate Hz] [--apply]
+    /// </summary>
+    static class DongleBalance
+    {
+        public static void Run(string[] args)
+        {
+            var seconds = 5;
+            var rate = 100;
+            var apply = false;
+
+            var positional = 0;
+            for (var i = 1; i < args.Length; i++)
+            {
+                if (args[i] == "--apply") apply = true;
+                else if (positional++ == 0) seconds = int.Parse(args[i]);
+                else rate = int.Parse(args[i]);
+            }
+
+            var devices = SensorDevices.GetDevices();
+            var sensors = new List<SensorDevice>();
+            var streams = new List<SensorStream>();
+            try
+            {
+                var dongles = devices.Where(d => d.IsDongle).Select(d => new WirelessDongle(d)).ToList();
+                if (dongles.Count < 2)
+                {
+                    Console.WriteLine("Balancing needs at least two dongles, found {0}.", dongles.Count);
+                    return;
+                }
+
+                var interval = (uint)(1000000 / rate);
+                foreach (var dongle in dongles)
+                {
+                    if (!dongle.Refresh()) continue;
+                    for (var id = 0; id < WirelessDongle.LogicalIdCount; id++)
+                    {
+                        if (dongle.Pairings[id] != 0) Open(dongle, id, interval, sensors, streams);
+                    }
+                }
+
+                var balancer = new DongleBalancer(dongles);
+                Thread.Sleep(1000);
+                var loads = balancer.Measure(streams, TimeSpan.FromSeconds(seconds));
+                Print("Before", loads);
+
+                var moves = balancer.Plan(loads);
+                foreach (var move in moves) Console.WriteLine("Move {0}", move);
+                if (moves.Count == 0) Console.WriteLine("Already balanced.");
+                if (!apply || moves.Count == 0) return;
+
+                var applied = balancer.Apply(moves, streams);
+                foreach (var move in applied)
+                {
+                    foreach (var stream in streams.Where(s => s.Device.SerialNumberValue == move.SerialNumber).ToArray())
+                    {
+                        streams.Remove(stream);
+                        stream.Dispose();
+                    }
+                    //The old device holds the sensor's previous id, close it before the sensor is opened again.
+                    foreach (var sensor in sensors.Where(s => s.SerialNumberValue == move.SerialNumber).ToArray())
+                    {
+                        sensors.Remove(sensor);
+                        sensor.Dispose();
+                    }
+                    Open(move.To, move.ToLogicalId, interval, sensors, streams);
+                }
+                Console.WriteLine("Moved {0} of {1} sensors.", applied.Count, moves.Count);
+
+                Thread.Sleep(1000);
+                Print("After", balancer.Measure(streams, TimeSpan.FromSeconds(seconds)));
+            }
+            finally
+            {
+                foreach (var stream in streams) stream.Dispose();
+                foreach (var sensor in sensors) sensor.Dispose();
+                foreach (var device in devices) device.Dispose();
+            }
+        }
+
+        private static void Open(WirelessDongle dongle, int logicalId, uint interval, List<SensorDevice> sensors, List<SensorStream> streams)
+        {
+            var sensor = dongle.OpenSensor(logicalId);
+            if (sensor == null) return;
+            sensors.Add(sensor);
+            var stream = new SensorStream(sensor, new StreamSlotLayout(StreamCommandEnum.TaredOrientationAsQuaternion), interval);
+            if (stream.Start()) streams.Add(stream);
+            else stream.Dispose();
+        }
+
+        private static void Print(string title, IList<DongleLoad> loads)
+        {
+            Console.WriteLine(title);
+            Console.WriteLine("{0,-10} {1,8} {2,8} {3,11} {4,11} {5,6}", "Dongle", "Channel", "Sensors", "Requested/s", "Delivered/s", "Slots");
+            foreach (var load in loads)
+            {
+                Console.WriteLine("{0,-10} {1,8} {2,8} {3,11:0} {4,11:0} {5,6}", load.Dongle.Device.SerialNumber, load.Dongle.Channel,
+                                  load.Sensors.Count, load.RequestedPacketsPerSecond, load.DeliveredPacketsPerSecond, load.SlotsOpen);
+            }
+            Console.WriteLine("{0,-10} {1,8} {2,8} {3,11:0} {4,11:0}", "Total", "", loads.Sum(l => l.Sensors.Count),
+                              loads.Sum(l => l.RequestedPacketsPerSecond), loads.Sum(l => l.DeliveredPacketsPerSecond));
+        }
+    }
+}
@@ -0,0 +1,177 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped;
+using YEISensorLib.Sharped.Analytics;
+using YEISensorLib.Sharped.Events;
+using YEISensorLib.Sharped.Recording;
+using YEISensorLib.Sharped.Simulation;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensor.ConsoleTest
+{
+    /// <summary>
+    /// Pushes a growing fleet of simulated sensors through streams, decoding and sinks to find where it stops scaling.
+    /// Usage: YEISensor.ConsoleTest fleet-load [sensor counts, e.g. 20,50,100,200,300] [seconds per step]
+    ///     [--rates 100,200,500] [--layouts imu,orientation,full] [--jitter us] [--loss p] [--timeouts p]
+    ///     [--threads n] [--spin us]
+    /// Rates and layouts are handed out to the sensors in turn.
+    /// Every stream feeds a latency sink, a compressed session log (discarded), windowed statistics and motion events.
+    /// </summary>
+    static class FleetLoadTest
+    {
+        private static readonly Dictionary<string, StreamSlotLayout> Layouts = new Dictionary<string, StreamSlotLayout>
+            {
+                { "orientation", new StreamSlotLayout(StreamCommandEnum.TaredOrientationAsQuaternion) },
+                { "imu", new StreamSlotLayout(StreamCommandEnum.TaredOrientationAsQuaternion,
+                                              StreamCommandEnum.AllCorrectedComponentSensorData,
+                                              StreamCommandEnum.ButtonState) },
+                { "full", new StreamSlotLayout(StreamCommandEnum.TaredOrientationAsQuaternion,
+                                               StreamCommandEnum.TaredOrientationAsEulerAngles,
+                                               StreamCommandEnum.AllCorrectedComponentSensorData,
+                                               StreamCommandEnum.CorrectedLinearAccelerationInGlobalSpace,
+                                               StreamCommandEnum.AllRawComponentSensorData,
+                                               StreamCommandEnum.TemperatureC,
+                                               StreamCommandEnum.BatteryPercentRemaining,
+                                               StreamCommandEnum.ButtonState) },
+            };
+
+        public static void Run(string[] args)
+        {
+            var counts = new[] { 20, 50, 100, 200, 300 };
+            var seconds = 10;
+            var rates = new[] { 200 };
+            var layouts = new[] { "imu" };
+            var options = new SimulatedDeviceOptions();
+            var threads = Math.Max(1, Environment.ProcessorCount / 2);
+            long spin = 0;
+
+            var positional = 0;
+            for (var i = 1; i < args.Length; i++)
+            {
+                switch (args[i])
+                {
+                    case "--rates": rates = args[++i].Split(',').Select(int.Parse).ToArray(); break;
+                    case "--layouts": layouts = args[++i].Split(','); break;
+                    case "--jitter": options.JitterMicroseconds = uint.Parse(args[++i]); break;
+                    case "--loss": options.LossRate = double.Parse(args[++i]); break;
+                    case "--timeouts": options.TimeoutRate = double.Parse(args[++i]); break;
+                    case "--threads": threads = int.Parse(args[++i]); break;
+                    case "--spin": spin = long.Parse(args[++i]); break;
+                    default:
+                        if (positional++ == 0) counts = args[i].Split(',').Select(int.Parse).ToArray();
+                        else seconds = int.Parse(args[i]);
+                        break;
+                }
+            }
+            if (layouts.Any(l => !Layouts.ContainsKey(l)))
+            {
+                Console.WriteLine("Layouts: {0}", string.Join(", ", Layouts.Keys));
+                return;
+            }
+
+            Console.WriteLine("{0} fleet threads, rates {1} Hz, layouts {2}, jitter {3}us, loss {4}, timeouts {5}, {6}s per step",
+                              threads, string.Join("/", rates), string.Join("/", layouts), options.JitterMicroseconds,
+                              options.LossRate, options.TimeoutRate, seconds);
+            Console.WriteLine("{0,7} {1,9} {2,9} {3,8} {4,8} {5,8} {6,8} {7,8} {8,8} {9,9} {10,8} {11,7} {12,7} {13,11}",
+                              "Sensors", "Pkt/s", "CPU%/sen", "Busy us", "p50 us", "p99 us", "p99.9 us", "Max us",
+                              "Inject%", "Shortfl%", "Lag ms", "Heap MB", "WS MB", "GC 0/1/2");
+
+            foreach (var count in counts)
+            {
+                Step(count, seconds, rates, layouts, options, threads, spin);
+            }
+        }
+
+        private static void Step(int count, int seconds, int[] rates, string[] layouts, SimulatedDeviceOptions options, int threads, long spin)
+        {
+            var latency = new LatencySink();
+            var windows = new WindowAggregationSink(count, 100, WindowQuantityEnum.AccelerometerMagnitude, 50, (sensor, statistics) => { });
+            var events = new SensorEventSink(new MotionTrigger("Impact", WindowQuantityEnum.AccelerometerMagnitude, 3));
+            var streams = new List<SensorStream>();
+            var logs = new List<CompressedSessionLogWriter>();
+            double packetsPerSecond = 0;
+
+            using (var fleet = new SimulatedFleet(threads) { SpinThresholdMicroseconds = spin })
+            {
+                latency.Fleet = fleet;
+                for (var i = 0; i < count; i++)
+                {
+                    var device = fleet.CreateDevice(new SimulatedDeviceOptions
+                                                        {
+                                                            JitterMicroseconds = options.JitterMicroseconds,
+                                                            LossRate = options.LossRate,
+                                                            TimeoutRate = options.TimeoutRate,
+                                                            TimeoutMicroseconds = options.TimeoutMicroseconds
+                                                        });
+                    var rate = rates[i % rates.Length];
+                    var layout = Layouts[layouts[i % layouts.Length]];
+                    var stream = new SensorStream(device, layout, (uint)(1000000 / rate));
+                    var log = new CompressedSessionLogWriter(Stream.Null, new SessionLogHeader(device.SerialNumberValue, layout), new StreamLogCodecOptions());
+                    stream.AddSink(latency);
+                    stream.AddSink(log);
+                    windows.Register(stream);
+                    stream.AddSink(events);
+                    streams.Add(stream);
+                    logs.Add(log);
+                    packetsPerSecond += rate;
+                }
+                foreach (var stream in streams) stream.Start();
+
+                //Warm up, then measure from a clean slate.
+                Thread.Sleep(2000);
+                fleet.ResetStatistics();
+                latency.Histogram.Reset();
+                var process = Process.GetCurrentProcess();
+                var gc = new[] { GC.CollectionCount(0), GC.CollectionCount(1), GC.CollectionCount(2) };
+                var cpu = process.TotalProcessorTime;
+                var watch = Stopwatch.StartNew();
+
+                Thread.Sleep(seconds * 1000);
+
+                var elapsed = watch.Elapsed.TotalSeconds;
+                process.Refresh();
+                var cpuSeconds = (process.TotalProcessorTime - cpu).TotalSeconds;
+                var busySeconds = fleet.BusyTime.TotalSeconds;
+                var devices = fleet.Devices;
+                var sent = devices.Sum(d => d.PacketsSent);
+                var injected = devices.Sum(d => d.PacketsLost + d.PacketsTimedOut);
+                var expected = packetsPerSecond * elapsed;
+                var maxLag = devices.Max(d => d.MaxLag.TotalMilliseconds);
+                var histogram = latency.Histogram;
+
+                Console.WriteLine("{0,7} {1,9:0} {2,9:0.000} {3,8:0.0} {4,8} {5,8} {6,8} {7,8} {8,8:0.00} {9,9:0.00} {10,8:0.0} {11,7:0.0} {12,7:0} {13,11}",
+                                  count, sent / elapsed,
+                                  cpuSeconds * 100 / elapsed / count,
+                                  sent == 0 ? 0 : busySeconds * 1e6 / sent,
+                                  histogram.Percentile(0.5), histogram.Percentile(0.99), histogram.Percentile(0.999), histogram.Max,
+                                  injected * 100 / expected,
+                                  Math.Max(0, expected - sent - injected) * 100 / expected,
+                                  maxLag,
+                                  GC.GetTotalMemory(false) / 1048576.0, process.WorkingSet64 / 1048576.0,
+                                  string.Join("/", gc.Select((n, generation) => GC.CollectionCount(generation) - n)));
+
+                foreach (var stream in streams) stream.Dispose();
+            }
+            foreach (var log in logs) log.Dispose();
+        }
+
+        /// <summary>
+        /// Latency from the simulated sensor timestamp to the sinks.
+        /// </summary>
+        private class LatencySink : IStreamSink
+        {
+            public readonly LatencyHistogram Histogram = new LatencyHistogram();
+            public SimulatedFleet Fleet;
+
+            public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+            {
+                Histogram.Record(unchecked((uint)Fleet.NowMicroseconds - sample.TimeStamp));
+            }
+        }
+    }
+}
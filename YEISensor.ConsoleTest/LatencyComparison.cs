@@ -0,0 +1,126 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped;
+using YEISensorLib.Sharped.Analytics;
+using YEISensorLib.Sharped.Simulation;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensor.ConsoleTest
+{
+    /// <summary>
+    /// Packet to sink latency of blocking reads against busy polling.
+    /// Usage: YEISensor.ConsoleTest latency-compare [sensors] [rate Hz] [seconds] [--cores 2,3] [--threads n] [--spin us] [--device]
+    /// Without --device the sensors are simulated, with it the connected sensors are switched to system timestamps.
+    /// </summary>
+    static class LatencyComparison
+    {
+        public static void Run(string[] args)
+        {
+            var sensors = 4;
+            var rate = 1000;
+            var seconds = 5;
+            var useDevices = false;
+            var options = new LowLatencyAcquisitionOptions();
+
+            var positional = 0;
+            for (var i = 1; i < args.Length; i++)
+            {
+                switch (args[i])
+                {
+                    case "--cores": options.Cores = args[++i].Split(',').Select(int.Parse).ToArray(); break;
+                    case "--threads": options.Threads = int.Parse(args[++i]); break;
+                    case "--spin": options.SpinMicroseconds = uint.Parse(args[++i]); break;
+                    case "--device": useDevices = true; break;
+                    default:
+                        switch (positional++)
+                        {
+                            case 0: sensors = int.Parse(args[i]); break;
+                            case 1: rate = int.Parse(args[i]); break;
+                            default: seconds = int.Parse(args[i]); break;
+                        }
+                        break;
+                }
+            }
+
+            Console.WriteLine("{0,-10} {1,8} {2,9} {3,8} {4,8} {5,8} {6,8} {7,8} {8,6} {9,6} {10,7}",
+                              "Mode", "Sensors", "Pkt/s", "p50 us", "p90 us", "p99 us", "p99.9 us", "Max us", "CPU%", "Pinned", "Parks");
+            foreach (var mode in new[] { AcquisitionModeEnum.Blocking, AcquisitionModeEnum.BusyPoll })
+            {
+                options.Mode = mode;
+                if (useDevices) MeasureDevices(options, rate, seconds);
+                else MeasureSimulated(options, sensors, rate, seconds);
+            }
+        }
+
+        private static void MeasureSimulated(LowLatencyAcquisitionOptions options, int sensors, int rate, int seconds)
+        {
+            using (var fleet = new SimulatedFleet(1) { SpinThresholdMicroseconds = 2000 })
+            {
+                var streams = Enumerable.Range(0, sensors)
+                                        .Select(i => new SensorStream(fleet.CreateDevice(new SimulatedDeviceOptions()), Layout(), (uint)(1000000 / rate)))
+                                        .ToArray();
+                using (var acquisition = new LowLatencyAcquisition(options, streams) { Clock = () => fleet.NowMicroseconds })
+                {
+                    Measure(acquisition, sensors, seconds);
+                }
+            }
+        }
+
+        private static void MeasureDevices(LowLatencyAcquisitionOptions options, int rate, int seconds)
+        {
+            var devices = SensorDevices.GetDevices().Where(d => !d.IsDongle).ToArray();
+            try
+            {
+                foreach (var device in devices) device.SetTimeStampMode(TimeStampModeEnum.System);
+                var streams = devices.Select(d => new SensorStream(d, Layout(), (uint)(1000000 / rate))).ToArray();
+                using (var acquisition = new LowLatencyAcquisition(options, streams))
+                {
+                    Measure(acquisition, devices.Length, seconds);
+                }
+            }
+            finally
+            {
+                foreach (var device in devices) device.Dispose();
+            }
+        }
+
+        private static StreamSlotLayout Layout()
+        {
+            return new StreamSlotLayout(StreamCommandEnum.TaredOrientationAsQuaternion, StreamCommandEnum.AllCorrectedComponentSensorData);
+        }
+
+        private static void Measure(LowLatencyAcquisition acquisition, int sensors, int seconds)
+        {
+            if (!acquisition.Start())
+            {
+                Console.WriteLine("{0,-10} streams did not start", acquisition.Mode);
+                return;
+            }
+
+            Thread.Sleep(1000);
+            acquisition.Latency.Reset();
+            var received = acquisition.Streams.Sum(s => s.PacketsReceived);
+            var process = Process.GetCurrentProcess();
+            var cpu = process.TotalProcessorTime;
+            var watch = Stopwatch.StartNew();
+
+            Thread.Sleep(seconds * 1000);
+
+            var elapsed = watch.Elapsed.TotalSeconds;
+            process.Refresh();
+            var cpuPercent = (process.TotalProcessorTime - cpu).TotalSeconds * 100 / elapsed;
+            var packets = acquisition.Streams.Sum(s => s.PacketsReceived) - received;
+            acquisition.Stop();
+
+            var latency = acquisition.Latency;
+            Console.WriteLine("{0,-10} {1,8} {2,9:0} {3,8} {4,8} {5,8} {6,8} {7,8} {8,6:0} {9,6} {10,7}",
+                              acquisition.Mode, sensors, packets / elapsed,
+                              latency.Percentile(0.5), latency.Percentile(0.9), latency.Percentile(0.99), latency.Percentile(0.999), latency.Max,
+                              cpuPercent, acquisition.PinnedThreads, acquisition.Parks);
+        }
+    }
+}
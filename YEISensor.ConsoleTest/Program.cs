@@ -8,6 +8,27 @@ namespace YEISensor.ConsoleTest
     {
         static void Main(string[] args)
         {
+            if (args.Length > 0 && args[0] == "codec-benchmark")
+            {
+                CodecBenchmark.Run(args.Length > 1 ? args[1] : null);
+                return;
+            }
+            if (args.Length > 0 && args[0] == "fleet-load")
+            {
+                FleetLoadTest.Run(args);
+                return;
+            }
+            if (args.Length > 0 && args[0] == "latency-compare")
+            {
+                LatencyComparison.Run(args);
+                return;
+            }
+            if (args.Length > 0 && args[0] == "dongle-balance")
+            {
+                DongleBalance.Run(args);
+                return;
+            }
+
             using (var device = SensorDevices.GetFirstAvailable())
             {
                 device.Tare();
@@ -31,5 +31,18 @@ namespace YEISensorLib.RawApi
         /// Timestamp of the data
         /// </summary>
         public uint TimeStamp;
+
+        /// <summary>
+        /// Unpacks the button bitfield returned by the sensor (bit 0 left, bit 1 right).
+        /// </summary>
+        public static ButtonState FromBitfield(byte bitfield, uint timeStamp)
+        {
+            return new ButtonState
+                       {
+                           LeftPressed = (byte)(bitfield & 0x01),
+                           RightPressed = (byte)((bitfield >> 1) & 0x01),
+                           TimeStamp = timeStamp
+                       };
+        }
     }
 }
@@ -0,0 +1,40 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.RawApi
+{
+    /**
+    * \brief A structure that contains information about the connected 3-Space device.
+    *
+    */
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct ComInfo //AKA TSS_ComInfo
+    {
+        /**
+        * \brief The type of 3-Space device connected through the com port.
+        */
+        public SensorTypeEnum DeviceType;
+        /**
+        * \brief The serial number for the 3-Space device connected through the com port.
+        */
+        public uint SerialNumber;
+        /**
+        * \brief The version of the firmware installed on the connected 3-Space device.
+        */
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 13)]
+        public string FirmwareVersion;
+        /**
+        * \brief The hardware revision and type of the connected 3-Space device.
+        */
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 33)]
+        public string HardwareVersion;
+        /**
+        * \brief Firmware compatibility level (TSS_Firmware_Compatibility).
+        */
+        public int FirmwareCompatibility;
+    }
+}
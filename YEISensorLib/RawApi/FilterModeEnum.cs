@@ -0,0 +1,21 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.RawApi
+{
+    /**
+    * \brief An enum expressing the different available filter modes.
+    * 
+    */
+    public enum FilterModeEnum : byte //AKA TSS_Filter_Mode
+    {
+        Imu, //TSS_FILTER_IMU
+        Kalman, //TSS_FILTER_KALMAN
+        AlternatingKalman, //TSS_FILTER_ALTERNATING_KALMAN
+        Complementary, //TSS_FILTER_COMPLEMENTARY
+        QuaternionGradientDescent //TSS_FILTER_QUATERNION_GRADIENT_DECENT
+    }
+}
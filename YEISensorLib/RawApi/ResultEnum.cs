@@ -19,6 +19,10 @@ namespace YEISensorLib.RawApi
         */
         NoError = 0,
         /**
+        * \brief The command returned a failed response.
+        */
+        ErrorCommandFail,
+        /**
         * \brief The API call was made on a device type that does not suppport the attemped command.
         */
         InvalidCommand,
@@ -27,36 +31,36 @@ namespace YEISensorLib.RawApi
         */
         InvalidId,
         /**
-        * \brief The index passed into a Wireless Sensor API call is used to look up a sensor serial number for a given dongle. If either the index is not 0<= index < 15 (the valid range of the index) or the stored serial number is 0 (meaning no wireless sensor is assigned to the index) this error is returned.
+        * \brief A parameter passed in to the API call was invalid.
         */
-        InvalidIndex,
+        ErrorParameter,
         /**
-        * \brief The API call executed had to fall back to an alternate implimentation to execute because the 3-Space device being used is on an old build of firmware. Firmware updating is suggested if this error is returned.
+        * \brief The command's timeout has been reached.
         */
-        WarningOldFirmware,  // Function can complete but is emulated, upgrading is highly recomended
+        ErrorTimeout,
         /**
-        * \brief The API call executed could not be completed because the connected 3-Space device has firmware that is too old to support the call. Firmware updating is suggested if this error is returned.
+        * \brief The API call executed failed to write all the data necisary to execute the command to the intended serial port.
         */
-        ErrorOldFirmware,    // Function is not available on this firmware, update it
+        ErrorWriting,
         /**
-        * \brief When creating a 3-Space device that is connected over USB there was an issue communicating with the intended device.
+        * \brief The API call executed failed to read all the data necisary to execute the command to the intended serial port.
         */
-        ErrorWithUsbConnection,
+        ErrorReading,
         /**
-        * \brief When creating a 3-Space device that is communicating through a 3-Space Dongle there was an issue communicating with the intended device.
+        * \brief The 3-Space device's stream slots are full.
         */
-        ErrorWithWirelessConnection,
+        ErrorStreamSlotsFull,
         /**
-        * \brief The API call executed failed to write all the data necisary to execute the command to the intended serial port.
+        * \brief The 3-Space device's stream configuration is corrupted.
         */
-        ErrorWriting,
+        ErrorStreamConfig,
         /**
-        * \brief The API call executed failed to read all the data necisary to execute the command to the intended serial port.
+        * \brief A memory error occurred in the API.
         */
-        ErrorReading,
+        ErrorMemory,
         /**
-        * \brief no sensor found when looking for sensors
+        * \brief The API call executed could not be completed because the connected 3-Space device has firmware that is too old to support the call. Firmware updating is suggested if this error is returned.
         */
-        ErrorNoSensor
+        ErrorFirmwareIncompatible
     }
 }
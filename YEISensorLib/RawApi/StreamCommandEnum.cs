@@ -0,0 +1,50 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.RawApi
+{
+    /**
+    * \brief An enum expressing the command list of Streamable Commands.
+    * 
+    */
+    public enum StreamCommandEnum : byte //AKA TSS_Stream_Command_Enum
+    {
+        TaredOrientationAsQuaternion = 0x00,
+        TaredOrientationAsEulerAngles = 0x01,
+        TaredOrientationAsRotationMatrix = 0x02,
+        TaredOrientationAsAxisAngle = 0x03,
+        TaredOrientationAsTwoVector = 0x04,
+        DifferenceQuaternion = 0x05,
+        UntaredOrientationAsQuaternion = 0x06,
+        UntaredOrientationAsEulerAngles = 0x07,
+        UntaredOrientationAsRotationMatrix = 0x08,
+        UntaredOrientationAsAxisAngle = 0x09,
+        UntaredOrientationAsTwoVector = 0x0a,
+        TaredTwoVectorInSensorFrame = 0x0b,
+        UntaredTwoVectorInSensorFrame = 0x0c,
+        AllNormalizedComponentSensorData = 0x20,
+        NormalizedGyroRate = 0x21,
+        NormalizedAccelerometerVector = 0x22,
+        NormalizedCompassVector = 0x23,
+        AllCorrectedComponentSensorData = 0x25,
+        CorrectedGyroRate = 0x26,
+        CorrectedAccelerometerVector = 0x27,
+        CorrectedCompassVector = 0x28,
+        CorrectedLinearAccelerationInGlobalSpace = 0x29,
+        TemperatureC = 0x2b,
+        TemperatureF = 0x2c,
+        ConfidenceFactor = 0x2d,
+        AllRawComponentSensorData = 0x40,
+        RawGyroscopeRate = 0x41,
+        RawAccelerometerData = 0x42,
+        RawCompassData = 0x43,
+        BatteryVoltage = 0xc9,
+        BatteryPercentRemaining = 0xca,
+        BatteryStatus = 0xcb,
+        ButtonState = 0xfa,
+        Null = 0xff //TSS_NULL, an unused slot
+    }
+}
@@ -0,0 +1,25 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.RawApi
+{
+    /**
+    * \brief Streaming data callback, called by the API for every stream packet.
+    *
+    * \param deviceId The device ID of the sensor.
+    * \param outputData The data the sensor returned.
+    * \param outputDataLength The size of the data returned.
+    * \param timeStamp Pointer to the timestamp in microseconds if timestamps are enabled.
+    */
+    [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+    public delegate void StreamDataCallback( //AKA TSS_CallBack
+        uint deviceId,
+        IntPtr outputData,
+        uint outputDataLength,
+        IntPtr timeStamp
+        );
+}
@@ -66,15 +66,29 @@ namespace YEISensorLib.RawApi
 
 
         /// <summary>
-        /// Retrieves a hexidecimal string representation of the 3-Space device's serial number (matching the representation on the case of the device).
+        /// Changes how the API timestamps the data of an open 3-Space device.
         /// </summary>
         /// <param name="deviceId">The identifier for the 3-Space device.</param>
-        /// <param name="serial">The char buffer to write the string into. Should have a length of 9 (8 for the hex string, 1 for a null terminator).</param>
+        /// <param name="timeStampMode">Sensor clock, host performance counter on arrival, or none.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setTimestampMode")]
+        public static extern ResultEnum SetTimeStampMode(
+            uint deviceId,
+            TimeStampModeEnum timeStampMode
+            );
+
+
+        /// <summary>
+        /// Retrieves the 3-Space device's serial number.
+        /// Format it as 8 hex digits to match the representation on the case of the device.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="serialNumber">The serial number is written to this variable.</param>
         /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
         [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi, EntryPoint = "tss_getSerialNumber")]
         public static extern ResultEnum GetSerialNumber(
             uint deviceId,
-            byte[] serialNumber,
+            out uint serialNumber,
             out uint timestamp
             );
 
@@ -196,10 +210,671 @@ namespace YEISensorLib.RawApi
             );
 
 
+        /// <summary>
+        /// Reads the state of the physical buttons on the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="buttonState">Bitfield of pressed buttons, bit 0 is the left button and bit 1 is the right button.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
         [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getButtonState")]
         public static extern ResultEnum GetButtonState(
-            uint deviceId, 
-            out ButtonState state
+            uint deviceId,
+            out byte buttonState,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets what drives the interrupt pin of the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="mode">Interrupt mode: 0 disabled, 1 pulse, 2 level.</param>
+        /// <param name="pin">Pin used for the interrupt: 0 none, 1 TXD, 2 MISO.</param>
+        /// <param name="timeStamp">Timestamp of the command.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setInterruptType")]
+        public static extern ResultEnum SetInterruptType(
+            uint deviceId,
+            byte mode,
+            byte pin,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the interrupt mode and pin of the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="mode">Interrupt mode is written to the referenced variable.</param>
+        /// <param name="pin">Interrupt pin is written to the referenced variable.</param>
+        /// <param name="timeStamp">Timestamp of the data.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getInterruptType")]
+        public static extern ResultEnum GetInterruptType(
+            uint deviceId,
+            out byte mode,
+            out byte pin,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads whether the sensor raised an interrupt since the last read, which clears it.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="status">1 if an interrupt was raised, 0 if not.</param>
+        /// <param name="timeStamp">Timestamp of the data.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getInterruptStatus")]
+        public static extern ResultEnum GetInterruptStatus(
+            uint deviceId,
+            out byte status,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Ends the current data-logging session on a data-logging sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_endDataLoggingSession")]
+        public static extern ResultEnum EndDataLoggingSession(
+            uint deviceId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Exposes the SD card of a data-logging sensor to the host as a mass storage drive.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_turnOnMassStorage")]
+        public static extern ResultEnum TurnOnMassStorage(
+            uint deviceId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Returns the SD card of a data-logging sensor to the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_turnOffMassStorage")]
+        public static extern ResultEnum TurnOffMassStorage(
+            uint deviceId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Retrieves the type, serial number and firmware information of a connected 3-Space device.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="comInfo">The device information is written to this structure.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getTSDeviceInfo")]
+        public static extern ResultEnum GetDeviceInfo(
+            uint deviceId,
+            out ComInfo comInfo
+            );
+
+
+        /// <summary>
+        /// Reads the orientation filter mode of the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="mode">The filter mode (FilterModeEnum) is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getFilterMode")]
+        public static extern ResultEnum GetFilterMode(
+            uint deviceId,
+            out byte mode,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the orientation filter mode of the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="mode">The filter mode (FilterModeEnum).</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setFilterMode")]
+        public static extern ResultEnum SetFilterMode(
+            uint deviceId,
+            byte mode,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the range setting of the accelerometer.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="rangeSetting">The range setting is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getAccelerometerRange")]
+        public static extern ResultEnum GetAccelerometerRange(
+            uint deviceId,
+            out byte rangeSetting,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the range setting of the accelerometer.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="rangeSetting">The range setting.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setAccelerometerRange")]
+        public static extern ResultEnum SetAccelerometerRange(
+            uint deviceId,
+            byte rangeSetting,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the range setting of the gyroscope.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="rangeSetting">The range setting is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getGyroscopeRange")]
+        public static extern ResultEnum GetGyroscopeRange(
+            uint deviceId,
+            out byte rangeSetting,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the range setting of the gyroscope.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="rangeSetting">The range setting.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setGyroscopeRange")]
+        public static extern ResultEnum SetGyroscopeRange(
+            uint deviceId,
+            byte rangeSetting,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the gyroscope calibration: a 3x3 scale matrix, row major, and the bias.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="matrix">An array of 9 floats the matrix is written to.</param>
+        /// <param name="bias">An array of 3 floats the bias is written to.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getGyroscopeCalibrationCoefficients")]
+        public static extern ResultEnum GetGyroscopeCalibrationCoefficients(
+            uint deviceId,
+            [Out] float[] matrix,
+            [Out] float[] bias,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the gyroscope calibration: a 3x3 scale matrix, row major, and the bias.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="matrix">9 floats, the matrix.</param>
+        /// <param name="bias">3 floats, the bias.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setGyroscopeCalibrationCoefficients")]
+        public static extern ResultEnum SetGyroscopeCalibrationCoefficients(
+            uint deviceId,
+            float[] matrix,
+            float[] bias,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the range setting of the compass.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="rangeSetting">The range setting is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getCompassRange")]
+        public static extern ResultEnum GetCompassRange(
+            uint deviceId,
+            out byte rangeSetting,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the range setting of the compass.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="rangeSetting">The range setting.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setCompassRange")]
+        public static extern ResultEnum SetCompassRange(
+            uint deviceId,
+            byte rangeSetting,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the minimum and maximum trust values the filter places on the accelerometer.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="minTrustValue">The minimum trust value is written to this variable.</param>
+        /// <param name="maxTrustValue">The maximum trust value is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getAccelerometerTrustValues")]
+        public static extern ResultEnum GetAccelerometerTrustValues(
+            uint deviceId,
+            out float minTrustValue,
+            out float maxTrustValue,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the minimum and maximum trust values the filter places on the accelerometer.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="minTrustValue">The minimum trust value.</param>
+        /// <param name="maxTrustValue">The maximum trust value.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setConfidenceAccelerometerTrustValues")]
+        public static extern ResultEnum SetAccelerometerTrustValues(
+            uint deviceId,
+            float minTrustValue,
+            float maxTrustValue,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the minimum and maximum trust values the filter places on the compass.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="minTrustValue">The minimum trust value is written to this variable.</param>
+        /// <param name="maxTrustValue">The maximum trust value is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getCompassTrustValues")]
+        public static extern ResultEnum GetCompassTrustValues(
+            uint deviceId,
+            out float minTrustValue,
+            out float maxTrustValue,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the minimum and maximum trust values the filter places on the compass.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="minTrustValue">The minimum trust value.</param>
+        /// <param name="maxTrustValue">The maximum trust value.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setConfidenceCompassTrustValues")]
+        public static extern ResultEnum SetCompassTrustValues(
+            uint deviceId,
+            float minTrustValue,
+            float maxTrustValue,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the axis direction byte of the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="axisDirections">The axis direction byte is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getAxisDirections")]
+        public static extern ResultEnum GetAxisDirections(
+            uint deviceId,
+            out byte axisDirections,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the axis direction byte of the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="axisDirections">The axis direction byte.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setAxisDirections")]
+        public static extern ResultEnum SetAxisDirections(
+            uint deviceId,
+            byte axisDirections,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the desired filter update period in microseconds.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="updateRate">The update period is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getDesiredUpdateRate")]
+        public static extern ResultEnum GetDesiredUpdateRate(
+            uint deviceId,
+            out uint updateRate,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the desired filter update period in microseconds, 0 runs the filter as fast as possible.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="updateRate">The update period.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setDesiredUpdateRate")]
+        public static extern ResultEnum SetDesiredUpdateRate(
+            uint deviceId,
+            uint updateRate,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the running average smoothing factor of the orientation.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="runningAveragePercent">The smoothing factor is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getRunningAveragePercent")]
+        public static extern ResultEnum GetRunningAveragePercent(
+            uint deviceId,
+            out float runningAveragePercent,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the running average smoothing factor of the orientation.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="runningAveragePercent">The smoothing factor.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setRunningAveragePercent")]
+        public static extern ResultEnum SetRunningAveragePercent(
+            uint deviceId,
+            float runningAveragePercent,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Saves the current settings of the 3-Space device to its non-volatile memory.
+        /// Each commit writes flash, only call it when something actually changed.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_commitSettings")]
+        public static extern ResultEnum CommitSettings(
+            uint deviceId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Configures the commands streamed by the sensor.
+        /// Unused slots must be set to StreamCommandEnum.Null.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="slots8">8 stream command bytes (StreamCommandEnum).</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setStreamingSlots")]
+        public static extern ResultEnum SetStreamingSlots(
+            uint deviceId,
+            byte[] slots8,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the commands streamed by the sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="slots8">Buffer of 8 bytes the stream commands are written to.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getStreamingSlots")]
+        public static extern ResultEnum GetStreamingSlots(
+            uint deviceId,
+            byte[] slots8,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Configures how often and for how long the sensor streams.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="interval">Microseconds between packets, 0 streams as fast as possible.</param>
+        /// <param name="duration">Microseconds to stream for, Defines.INF_DURATION to stream until stopped.</param>
+        /// <param name="delay">Microseconds to wait before the first packet.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setStreamingTiming")]
+        public static extern ResultEnum SetStreamingTiming(
+            uint deviceId,
+            uint interval,
+            uint duration,
+            uint delay,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Starts streaming with the configured slots and timing.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_startStreaming")]
+        public static extern ResultEnum StartStreaming(
+            uint deviceId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Stops streaming.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_stopStreaming")]
+        public static extern ResultEnum StopStreaming(
+            uint deviceId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Copies the last stream packet received from the sensor.
+        /// Non-blocking, returns ErrorReading if no packet has arrived yet.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="outputData">Buffer the packet is copied to.</param>
+        /// <param name="outputDataLength">Size of the packet (StreamSlotLayout.PayloadSize).</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getLastStreamData")]
+        public static extern ResultEnum GetLastStreamData(
+            uint deviceId,
+            byte[] outputData,
+            uint outputDataLength,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Waits for the next stream packet from the sensor and copies it.
+        /// Blocking, good for data logging.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="outputData">Buffer the packet is copied to.</param>
+        /// <param name="outputDataLength">Size of the packet (StreamSlotLayout.PayloadSize).</param>
+        /// <param name="timeout">Milliseconds to wait for a packet.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getLatestStreamData")]
+        public static extern ResultEnum GetLatestStreamData(
+            uint deviceId,
+            byte[] outputData,
+            uint outputDataLength,
+            uint timeout,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Registers a function the API calls on its own thread for every stream packet.
+        /// Keep a reference to the delegate for as long as it is registered, pass null to unregister.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="callback">The function to call.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setNewDataCallBack")]
+        public static extern ResultEnum SetNewDataCallBack(
+            uint deviceId,
+            StreamDataCallback callback
+            );
+
+
+        /// <summary>
+        /// Creates a device id for a wireless sensor paired with a dongle, or returns the one already created.
+        /// The sensor inherits the dongle's timestamp mode.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="logicalId">The logical id of the sensor on the dongle, 0-14.</param>
+        /// <param name="wirelessDeviceId">The device id of the wireless sensor, NO_DEVICE_ID if it failed.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getSensorFromDongle")]
+        public static extern ResultEnum GetSensorFromDongle(
+            uint deviceId,
+            int logicalId,
+            out uint wirelessDeviceId
+            );
+
+
+        /// <summary>
+        /// Reads the serial number of the sensor paired at a logical id of a dongle.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="logicalId">The logical id, 0-14.</param>
+        /// <param name="serialNumber">The serial number is written to this variable, 0 if none is paired.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getSerialNumberAtLogicalID")]
+        public static extern ResultEnum GetSerialNumberAtLogicalId(
+            uint deviceId,
+            byte logicalId,
+            out uint serialNumber,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Pairs a sensor at a logical id of a dongle. Takes effect once committed with CommitWirelessSettings.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="logicalId">The logical id, 0-14.</param>
+        /// <param name="serialNumber">The serial number of the sensor, 0 to clear the id.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setSerialNumberAtLogicalID")]
+        public static extern ResultEnum SetSerialNumberAtLogicalId(
+            uint deviceId,
+            byte logicalId,
+            uint serialNumber,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads how many wireless slots of the dongle are open.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="slotsOpen">The number of open slots is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getWirelessSlotsOpen")]
+        public static extern ResultEnum GetWirelessSlotsOpen(
+            uint deviceId,
+            out byte slotsOpen,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the wireless pan id of a dongle or wireless sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="panId">The pan id is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getWirelessPanID")]
+        public static extern ResultEnum GetWirelessPanId(
+            uint deviceId,
+            out ushort panId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the wireless pan id of a dongle or wireless sensor. Takes effect once committed with CommitWirelessSettings.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="panId">The pan id.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setWirelessPanID")]
+        public static extern ResultEnum SetWirelessPanId(
+            uint deviceId,
+            ushort panId,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Reads the wireless channel of a dongle or wireless sensor.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="channel">The channel is written to this variable.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_getWirelessChannel")]
+        public static extern ResultEnum GetWirelessChannel(
+            uint deviceId,
+            out byte channel,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Sets the wireless channel of a dongle or wireless sensor. Takes effect once committed with CommitWirelessSettings.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <param name="channel">The channel, 11-26.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_setWirelessChannel")]
+        public static extern ResultEnum SetWirelessChannel(
+            uint deviceId,
+            byte channel,
+            out uint timeStamp
+            );
+
+
+        /// <summary>
+        /// Saves and applies the wireless settings: pan id, channel and the logical id table of a dongle.
+        /// </summary>
+        /// <param name="deviceId">The identifier for the 3-Space device.</param>
+        /// <returns>An error code indicating either success or failure to execute the call. The code will also indicate the reason for the failure.</returns>
+        [DllImport("ThreeSpace_API.dll", CallingConvention = CallingConvention.Cdecl, EntryPoint = "tss_commitWirelessSettings")]
+        public static extern ResultEnum CommitWirelessSettings(
+            uint deviceId,
+            out uint timeStamp
             );
     }
 
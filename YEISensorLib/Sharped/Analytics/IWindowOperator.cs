@@ -0,0 +1,34 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// A statistic maintained incrementally over a SlidingWindow.
+    /// Each push costs O(1) (amortized), whatever the window size.
+    /// </summary>
+    public interface IWindowOperator
+    {
+        /// <summary>
+        /// Called once when the operator is added to a window.
+        /// </summary>
+        void Attach(SlidingWindow window);
+
+        /// <summary>
+        /// A value entered the window of one sensor.
+        /// </summary>
+        /// <param name="sensor">Sensor index.</param>
+        /// <param name="added">The new value.</param>
+        /// <param name="evicted">True if the window was full and removed fell out of it.</param>
+        /// <param name="removed">The value that left the window, if evicted.</param>
+        void Push(int sensor, float added, bool evicted, float removed);
+
+        /// <summary>
+        /// One value entered the window of every sensor. Arrays are indexed by sensor.
+        /// </summary>
+        void PushAll(float[] added, bool[] evicted, float[] removed);
+    }
+}
@@ -0,0 +1,116 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Thread safe histogram of non-negative values (e.g. latencies in microseconds) for percentiles and tails.
+    /// 
+    /// Buckets are log-linear: exact below 64, then 32 buckets per power of two, so any percentile is within
+    /// about 3% of the true value, in a fixed 15KB whatever the count. Record is one Interlocked increment.
+    /// </summary>
+    public class LatencyHistogram
+    {
+        private const int SubBits = 5;
+        private const int SubCount = 1 << SubBits;
+        private const int LinearLimit = SubCount * 2;
+        private const int BucketCount = LinearLimit + (63 - SubBits - 1) * SubCount;
+
+        private readonly long[] _buckets = new long[BucketCount];
+        private long _count;
+        private long _sum;
+        private long _max;
+
+        public long Count { get { return Interlocked.Read(ref _count); } }
+
+        public long Max { get { return Interlocked.Read(ref _max); } }
+
+        public double Mean
+        {
+            get
+            {
+                var count = Count;
+                return count == 0 ? 0 : (double)Interlocked.Read(ref _sum) / count;
+            }
+        }
+
+        public void Record(long value)
+        {
+            if (value < 0) value = 0;
+            Interlocked.Increment(ref _buckets[BucketOf(value)]);
+            Interlocked.Increment(ref _count);
+            Interlocked.Add(ref _sum, value);
+
+            var max = Interlocked.Read(ref _max);
+            while (value > max)
+            {
+                var seen = Interlocked.CompareExchange(ref _max, value, max);
+                if (seen == max) break;
+                max = seen;
+            }
+        }
+
+        /// <summary>
+        /// Value below which the given fraction of the recorded values are, e.g. 0.99.
+        /// Reports the upper bound of the bucket, or Max if lower.
+        /// </summary>
+        public long Percentile(double fraction)
+        {
+            var count = Count;
+            if (count == 0) return 0;
+
+            var rank = (long)Math.Ceiling(Math.Min(1, Math.Max(0, fraction)) * count);
+            if (rank < 1) rank = 1;
+            long seen = 0;
+            for (var bucket = 0; bucket < BucketCount; bucket++)
+            {
+                seen += Interlocked.Read(ref _buckets[bucket]);
+                if (seen >= rank) return Math.Min(UpperBoundOf(bucket), Max);
+            }
+            return Max;
+        }
+
+        public void Reset()
+        {
+            for (var bucket = 0; bucket < BucketCount; bucket++) Interlocked.Exchange(ref _buckets[bucket], 0);
+            Interlocked.Exchange(ref _count, 0);
+            Interlocked.Exchange(ref _sum, 0);
+            Interlocked.Exchange(ref _max, 0);
+        }
+
+        private static int BucketOf(long value)
+        {
+            if (value < LinearLimit) return (int)value;
+
+            var exponent = 63 - LeadingZeros(value) - SubBits;
+            var sub = (int)(value >> exponent) - SubCount;
+            return LinearLimit + (exponent - 1) * SubCount + sub;
+        }
+
+        private static long UpperBoundOf(int bucket)
+        {
+            if (bucket < LinearLimit) return bucket;
+
+            var exponent = (bucket - LinearLimit) / SubCount + 1;
+            var sub = (bucket - LinearLimit) % SubCount + SubCount;
+            return ((long)(sub + 1) << exponent) - 1;
+        }
+
+        private static int LeadingZeros(long value)
+        {
+            var zeros = 0;
+            var bits = (ulong)value;
+            if (bits >> 32 == 0) { zeros += 32; bits <<= 32; }
+            if (bits >> 48 == 0) { zeros += 16; bits <<= 16; }
+            if (bits >> 56 == 0) { zeros += 8; bits <<= 8; }
+            if (bits >> 60 == 0) { zeros += 4; bits <<= 4; }
+            if (bits >> 62 == 0) { zeros += 2; bits <<= 2; }
+            if (bits >> 63 == 0) zeros += 1;
+            return zeros;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Sliding minimum and maximum using monotonic deques of push indices.
+    /// Each value is added to and removed from each deque at most once, so pushes are O(1) amortized.
+    /// The deques are rings of WindowSize entries per sensor in flat arrays.
+    /// </summary>
+    public class SlidingMinMax : IWindowOperator
+    {
+        private SlidingWindow _window;
+        private int _size;
+
+        private long[] _minIndices;
+        private int[] _minHeads;
+        private int[] _minCounts;
+
+        private long[] _maxIndices;
+        private int[] _maxHeads;
+        private int[] _maxCounts;
+
+        public void Attach(SlidingWindow window)
+        {
+            _window = window;
+            _size = window.WindowSize;
+            _minIndices = new long[window.SensorCount * _size];
+            _minHeads = new int[window.SensorCount];
+            _minCounts = new int[window.SensorCount];
+            _maxIndices = new long[window.SensorCount * _size];
+            _maxHeads = new int[window.SensorCount];
+            _maxCounts = new int[window.SensorCount];
+        }
+
+        public float Min(int sensor)
+        {
+            return _minCounts[sensor] == 0 ? 0 : _window.ValueAt(sensor, _minIndices[sensor * _size + _minHeads[sensor]]);
+        }
+
+        public float Max(int sensor)
+        {
+            return _maxCounts[sensor] == 0 ? 0 : _window.ValueAt(sensor, _maxIndices[sensor * _size + _maxHeads[sensor]]);
+        }
+
+        public void Push(int sensor, float added, bool evicted, float removed)
+        {
+            var index = _window.Total(sensor) - 1;
+            Update(sensor, index, added, _minIndices, _minHeads, _minCounts, false);
+            Update(sensor, index, added, _maxIndices, _maxHeads, _maxCounts, true);
+        }
+
+        public void PushAll(float[] added, bool[] evicted, float[] removed)
+        {
+            for (var sensor = 0; sensor < added.Length; sensor++)
+            {
+                var index = _window.Total(sensor) - 1;
+                Update(sensor, index, added[sensor], _minIndices, _minHeads, _minCounts, false);
+            }
+            for (var sensor = 0; sensor < added.Length; sensor++)
+            {
+                var index = _window.Total(sensor) - 1;
+                Update(sensor, index, added[sensor], _maxIndices, _maxHeads, _maxCounts, true);
+            }
+        }
+
+        private void Update(int sensor, long index, float value, long[] indices, int[] heads, int[] counts, bool keepLargest)
+        {
+            var baseOffset = sensor * _size;
+            var head = heads[sensor];
+            var count = counts[sensor];
+
+            //Drop the front once it slid out of the window.
+            if (count > 0 && indices[baseOffset + head] <= index - _size)
+            {
+                head = head + 1 == _size ? 0 : head + 1;
+                count--;
+            }
+
+            //Drop values from the back that can never be the extreme again.
+            while (count > 0)
+            {
+                var tail = head + count - 1;
+                if (tail >= _size) tail -= _size;
+                var tailValue = _window.ValueAt(sensor, indices[baseOffset + tail]);
+                if (keepLargest ? tailValue > value : tailValue < value) break;
+                count--;
+            }
+
+            var slot = head + count;
+            if (slot >= _size) slot -= _size;
+            indices[baseOffset + slot] = index;
+            heads[sensor] = head;
+            counts[sensor] = count + 1;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Sliding sum and sum of squares, giving the moving average and RMS.
+    /// Add/subtract drift is removed by re-summing the window once per wrap, O(1) amortized.
+    /// </summary>
+    public class SlidingSum : IWindowOperator
+    {
+        private SlidingWindow _window;
+        private double[] _sums;
+        private double[] _squares;
+
+        public void Attach(SlidingWindow window)
+        {
+            _window = window;
+            _sums = new double[window.SensorCount];
+            _squares = new double[window.SensorCount];
+        }
+
+        public double Sum(int sensor)
+        {
+            return _sums[sensor];
+        }
+
+        public double Mean(int sensor)
+        {
+            var count = _window.Count(sensor);
+            return count == 0 ? 0 : _sums[sensor] / count;
+        }
+
+        public double Rms(int sensor)
+        {
+            var count = _window.Count(sensor);
+            return count == 0 ? 0 : Math.Sqrt(Math.Max(0, _squares[sensor]) / count);
+        }
+
+        public void Push(int sensor, float added, bool evicted, float removed)
+        {
+            _sums[sensor] += added;
+            _squares[sensor] += (double)added * added;
+            if (!evicted) return;
+            _sums[sensor] -= removed;
+            _squares[sensor] -= (double)removed * removed;
+            if (_window.Total(sensor) % _window.WindowSize == 0) Resum(sensor);
+        }
+
+        public void PushAll(float[] added, bool[] evicted, float[] removed)
+        {
+            var sums = _sums;
+            var squares = _squares;
+            for (var sensor = 0; sensor < sums.Length; sensor++)
+            {
+                double a = added[sensor];
+                double r = evicted[sensor] ? removed[sensor] : 0f;
+                sums[sensor] += a - r;
+                squares[sensor] += a * a - r * r;
+            }
+            for (var sensor = 0; sensor < sums.Length; sensor++)
+            {
+                if (evicted[sensor] && _window.Total(sensor) % _window.WindowSize == 0) Resum(sensor);
+            }
+        }
+
+        private void Resum(int sensor)
+        {
+            double sum = 0, squares = 0;
+            var last = _window.Total(sensor);
+            for (var index = last - _window.Count(sensor); index < last; index++)
+            {
+                double value = _window.ValueAt(sensor, index);
+                sum += value;
+                squares += value * value;
+            }
+            _sums[sensor] = sum;
+            _squares[sensor] = squares;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Sliding mean and variance using Welford's update, extended to remove the value leaving the window.
+    /// Stays accurate where the sum of squares formula cancels catastrophically (large mean, small spread).
+    /// </summary>
+    public class SlidingVariance : IWindowOperator
+    {
+        private SlidingWindow _window;
+        private double[] _means;
+        private double[] _m2;
+
+        public void Attach(SlidingWindow window)
+        {
+            _window = window;
+            _means = new double[window.SensorCount];
+            _m2 = new double[window.SensorCount];
+        }
+
+        public double Mean(int sensor)
+        {
+            return _means[sensor];
+        }
+
+        /// <summary>
+        /// Population variance of the window.
+        /// </summary>
+        public double Variance(int sensor)
+        {
+            var count = _window.Count(sensor);
+            return count == 0 ? 0 : Math.Max(0, _m2[sensor]) / count;
+        }
+
+        /// <summary>
+        /// Sample (n - 1) variance of the window.
+        /// </summary>
+        public double SampleVariance(int sensor)
+        {
+            var count = _window.Count(sensor);
+            return count < 2 ? 0 : Math.Max(0, _m2[sensor]) / (count - 1);
+        }
+
+        public double StandardDeviation(int sensor)
+        {
+            return Math.Sqrt(Variance(sensor));
+        }
+
+        public void Push(int sensor, float added, bool evicted, float removed)
+        {
+            Update(sensor, added, evicted, removed);
+        }
+
+        public void PushAll(float[] added, bool[] evicted, float[] removed)
+        {
+            for (var sensor = 0; sensor < _means.Length; sensor++)
+            {
+                Update(sensor, added[sensor], evicted[sensor], removed[sensor]);
+            }
+        }
+
+        private void Update(int sensor, double added, bool evicted, double removed)
+        {
+            var mean = _means[sensor];
+            if (evicted)
+            {
+                //Replace removed with added, the count is unchanged.
+                var newMean = mean + (added - removed) / _window.Count(sensor);
+                _m2[sensor] += (added - removed) * (added - newMean + removed - mean);
+                _means[sensor] = newMean;
+            }
+            else
+            {
+                var delta = added - mean;
+                var newMean = mean + delta / _window.Count(sensor);
+                _m2[sensor] += delta * (added - newMean);
+                _means[sensor] = newMean;
+            }
+        }
+    }
+}
@@ -0,0 +1,119 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// The last WindowSize values of a quantity for each of SensorCount sensors, with operators kept up to date as values arrive.
+    /// 
+    /// Storage is structure of arrays: one flat array holds every sensor's ring back to back, and the per-sensor
+    /// state of each operator lives in arrays indexed by sensor, so a batch push walks contiguous memory.
+    /// A sensor's pushes must come from one thread at a time, different sensors may be pushed concurrently.
+    /// </summary>
+    public class SlidingWindow
+    {
+        private readonly float[] _values;
+        private readonly int[] _positions;
+        private readonly int[] _counts;
+        private readonly long[] _totals;
+        private readonly IWindowOperator[] _operators;
+
+        private readonly bool[] _batchEvicted;
+        private readonly float[] _batchRemoved;
+
+        public int SensorCount { get; private set; }
+        public int WindowSize { get; private set; }
+
+        public SlidingWindow(int sensorCount, int windowSize, params IWindowOperator[] operators)
+        {
+            if (sensorCount <= 0) throw new ArgumentOutOfRangeException("sensorCount");
+            if (windowSize <= 0) throw new ArgumentOutOfRangeException("windowSize");
+
+            SensorCount = sensorCount;
+            WindowSize = windowSize;
+            _values = new float[sensorCount * windowSize];
+            _positions = new int[sensorCount];
+            _counts = new int[sensorCount];
+            _totals = new long[sensorCount];
+            _batchEvicted = new bool[sensorCount];
+            _batchRemoved = new float[sensorCount];
+            _operators = operators;
+            foreach (var op in operators) op.Attach(this);
+        }
+
+        /// <summary>
+        /// Number of values currently in the sensor's window.
+        /// </summary>
+        public int Count(int sensor)
+        {
+            return _counts[sensor];
+        }
+
+        /// <summary>
+        /// Number of values ever pushed for the sensor.
+        /// </summary>
+        public long Total(int sensor)
+        {
+            return _totals[sensor];
+        }
+
+        /// <summary>
+        /// Value at an absolute push index (0 is the first value ever pushed), must still be inside the window.
+        /// </summary>
+        public float ValueAt(int sensor, long index)
+        {
+            return _values[sensor * WindowSize + (int)(index % WindowSize)];
+        }
+
+        /// <summary>
+        /// Copy the sensor's window, oldest first, into buffer.
+        /// </summary>
+        /// <returns>Number of values copied.</returns>
+        public int CopyWindow(int sensor, float[] buffer)
+        {
+            var count = Math.Min(_counts[sensor], buffer.Length);
+            var first = _totals[sensor] - count;
+            for (var i = 0; i < count; i++) buffer[i] = ValueAt(sensor, first + i);
+            return count;
+        }
+
+        /// <summary>
+        /// Add a value to one sensor's window.
+        /// </summary>
+        public void Push(int sensor, float value)
+        {
+            bool evicted;
+            var removed = Store(sensor, value, out evicted);
+            for (var i = 0; i < _operators.Length; i++) _operators[i].Push(sensor, value, evicted, removed);
+        }
+
+        /// <summary>
+        /// Add one value to every sensor's window.
+        /// </summary>
+        /// <param name="values">One value per sensor.</param>
+        public void PushAll(float[] values)
+        {
+            for (var sensor = 0; sensor < SensorCount; sensor++)
+            {
+                _batchRemoved[sensor] = Store(sensor, values[sensor], out _batchEvicted[sensor]);
+            }
+            for (var i = 0; i < _operators.Length; i++) _operators[i].PushAll(values, _batchEvicted, _batchRemoved);
+        }
+
+        private float Store(int sensor, float value, out bool evicted)
+        {
+            var slot = sensor * WindowSize + _positions[sensor];
+            evicted = _counts[sensor] == WindowSize;
+            var removed = evicted ? _values[slot] : 0f;
+
+            _values[slot] = value;
+            _positions[sensor] = _positions[sensor] + 1 == WindowSize ? 0 : _positions[sensor] + 1;
+            if (!evicted) _counts[sensor]++;
+            _totals[sensor]++;
+            return removed;
+        }
+    }
+}
@@ -0,0 +1,152 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Stream sink computing windowed mean, RMS, min, max and variance of one quantity per sensor.
+    /// Statistics are updated on every sample, and emitted to the output every EmitEvery samples (downsampling).
+    /// 
+    /// Usage:
+    ///     var aggregation = new WindowAggregationSink(streams.Length, 100, WindowQuantityEnum.GyroMagnitude, 10, (sensor, stats) => ...);
+    ///     foreach (var stream in streams) aggregation.Register(stream);
+    /// </summary>
+    public class WindowAggregationSink : IStreamSink
+    {
+        private readonly SlidingWindow _window;
+        private readonly SlidingSum _sum = new SlidingSum();
+        private readonly SlidingMinMax _minMax = new SlidingMinMax();
+        private readonly SlidingVariance _variance = new SlidingVariance();
+        private readonly Action<int, WindowStatistics> _output;
+        private readonly uint[] _timeStamps;
+        private readonly float[] _batchValues;
+
+        private Dictionary<SensorStream, int> _sensors = new Dictionary<SensorStream, int>();
+        private readonly object _registerLock = new object();
+
+        public WindowQuantityEnum Quantity { get; private set; }
+
+        /// <summary>
+        /// Samples between two outputs for a sensor, 1 outputs every sample.
+        /// </summary>
+        public int EmitEvery { get; private set; }
+
+        public SlidingWindow Window { get { return _window; } }
+
+        /// <param name="sensorCount">Maximum number of streams that can be registered.</param>
+        /// <param name="windowSize">Window length in samples.</param>
+        /// <param name="quantity">Value to aggregate.</param>
+        /// <param name="emitEvery">Samples between two outputs for a sensor.</param>
+        /// <param name="output">Receives the sensor index and its statistics, on the acquisition thread. May be null to poll with Statistics.</param>
+        public WindowAggregationSink(int sensorCount, int windowSize, WindowQuantityEnum quantity, int emitEvery, Action<int, WindowStatistics> output)
+        {
+            if (emitEvery <= 0) throw new ArgumentOutOfRangeException("emitEvery");
+
+            _window = new SlidingWindow(sensorCount, windowSize, _sum, _minMax, _variance);
+            _timeStamps = new uint[sensorCount];
+            _batchValues = new float[sensorCount];
+            Quantity = quantity;
+            EmitEvery = emitEvery;
+            _output = output;
+        }
+
+        /// <summary>
+        /// Give the stream the next sensor index and subscribe to it.
+        /// </summary>
+        /// <returns>The sensor index used in outputs.</returns>
+        public int Register(SensorStream stream)
+        {
+            int sensor;
+            lock (_registerLock)
+            {
+                if (_sensors.TryGetValue(stream, out sensor)) return sensor;
+                sensor = _sensors.Count;
+                if (sensor >= _window.SensorCount) throw new ArgumentOutOfRangeException("stream", "All sensor indices are in use.");
+
+                //Copy on write so OnSample reads without locking.
+                var sensors = new Dictionary<SensorStream, int>(_sensors);
+                sensors.Add(stream, sensor);
+                Volatile.Write(ref _sensors, sensors);
+            }
+            stream.AddSink(this);
+            return sensor;
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            int sensor;
+            if (!Volatile.Read(ref _sensors).TryGetValue(stream, out sensor)) return;
+            Add(sensor, ref sample);
+        }
+
+        /// <summary>
+        /// Feed a sample directly, for sources other than a SensorStream.
+        /// </summary>
+        public void Add(int sensor, ref SensorSample sample)
+        {
+            _timeStamps[sensor] = sample.TimeStamp;
+            _window.Push(sensor, Extract(Quantity, ref sample));
+
+            if (_output != null && _window.Total(sensor) % EmitEvery == 0)
+            {
+                _output(sensor, Statistics(sensor));
+            }
+        }
+
+        /// <summary>
+        /// Feed one sample per sensor at once, samples are indexed by sensor.
+        /// </summary>
+        public void AddAll(SensorSample[] samples)
+        {
+            var values = _batchValues;
+            for (var sensor = 0; sensor < values.Length; sensor++)
+            {
+                _timeStamps[sensor] = samples[sensor].TimeStamp;
+                values[sensor] = Extract(Quantity, ref samples[sensor]);
+            }
+            _window.PushAll(values);
+
+            if (_output == null || _window.Total(0) % EmitEvery != 0) return;
+            for (var sensor = 0; sensor < values.Length; sensor++) _output(sensor, Statistics(sensor));
+        }
+
+        /// <summary>
+        /// Current statistics of a sensor's window.
+        /// </summary>
+        public WindowStatistics Statistics(int sensor)
+        {
+            return new WindowStatistics
+            {
+                TimeStamp = _timeStamps[sensor],
+                Count = _window.Count(sensor),
+                Mean = (float)_variance.Mean(sensor),
+                Rms = (float)_sum.Rms(sensor),
+                Min = _minMax.Min(sensor),
+                Max = _minMax.Max(sensor),
+                Variance = (float)_variance.Variance(sensor),
+            };
+        }
+
+        public static float Extract(WindowQuantityEnum quantity, ref SensorSample sample)
+        {
+            switch (quantity)
+            {
+                case WindowQuantityEnum.GyroMagnitude: return Magnitude(sample.Gyro);
+                case WindowQuantityEnum.AccelerometerMagnitude: return Magnitude(sample.Accelerometer);
+                case WindowQuantityEnum.CompassMagnitude: return Magnitude(sample.Compass);
+            }
+            return 0;
+        }
+
+        private static float Magnitude(Vector3F vector)
+        {
+            return (float)Math.Sqrt(vector.X * vector.X + vector.Y * vector.Y + vector.Z * vector.Z);
+        }
+    }
+}
@@ -0,0 +1,18 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Scalar taken from each sample to feed a window.
+    /// </summary>
+    public enum WindowQuantityEnum
+    {
+        GyroMagnitude,
+        AccelerometerMagnitude,
+        CompassMagnitude,
+    }
+}
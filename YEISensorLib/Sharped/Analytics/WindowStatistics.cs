@@ -0,0 +1,25 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Analytics
+{
+    /// <summary>
+    /// Snapshot of a sensor's window, emitted by WindowAggregationSink.
+    /// </summary>
+    public struct WindowStatistics
+    {
+        /// <summary>
+        /// Timestamp of the newest sample in the window
+        /// </summary>
+        public uint TimeStamp;
+        public int Count;
+        public float Mean;
+        public float Rms;
+        public float Min;
+        public float Max;
+        public float Variance;
+    }
+}
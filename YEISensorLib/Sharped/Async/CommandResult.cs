@@ -0,0 +1,32 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Async
+{
+    /// <summary>
+    /// The outcome of an asynchronous sensor command.
+    /// </summary>
+    public struct CommandResult<T>
+    {
+        public ResultEnum Result;
+        public T Value;
+
+        /// <summary>
+        /// Timestamp of the data
+        /// </summary>
+        public uint TimeStamp;
+
+        public bool Success { get { return Result == ResultEnum.NoError; } }
+
+        public CommandResult(ResultEnum result, T value, uint timeStamp)
+        {
+            Result = result;
+            Value = value;
+            TimeStamp = timeStamp;
+        }
+    }
+}
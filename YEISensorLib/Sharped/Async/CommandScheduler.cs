@@ -0,0 +1,87 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Async
+{
+    /// <summary>
+    /// Runs blocking API calls on a small set of dedicated threads, outside the thread pool.
+    /// 
+    /// Commands are queued per device and a device is only ever run by one worker at a time,
+    /// so a worker never sits blocked on the API's per-device lock while another device has work.
+    /// </summary>
+    public class CommandScheduler
+    {
+        private const int CommandsPerTurn = 8;
+
+        private static readonly Lazy<CommandScheduler> _default = new Lazy<CommandScheduler>(() => new CommandScheduler(Math.Max(2, Environment.ProcessorCount)));
+
+        private readonly BlockingCollection<DeviceCommandQueue> _ready = new BlockingCollection<DeviceCommandQueue>();
+
+        /// <summary>
+        /// The scheduler used by SensorDevice async commands.
+        /// </summary>
+        public static CommandScheduler Default { get { return _default.Value; } }
+
+        public int WorkerCount { get; private set; }
+
+        public CommandScheduler(int workerCount)
+        {
+            WorkerCount = workerCount;
+            for (var i = 0; i < workerCount; i++)
+            {
+                new Thread(Work) { IsBackground = true, Name = "YEI command worker " + i }.Start();
+            }
+        }
+
+        internal void Schedule(DeviceCommandQueue queue)
+        {
+            _ready.Add(queue);
+        }
+
+        private void Work()
+        {
+            foreach (var queue in _ready.GetConsumingEnumerable())
+            {
+                //Run a few commands then yield the worker, so a busy device cannot starve the others.
+                for (var i = 0; i < CommandsPerTurn; i++)
+                {
+                    Action command;
+                    if (!queue.TryDequeue(out command)) break;
+                    command();
+                }
+                queue.Release(this);
+            }
+        }
+    }
+
+    /// <summary>
+    /// The pending commands of one device.
+    /// </summary>
+    internal class DeviceCommandQueue
+    {
+        private readonly ConcurrentQueue<Action> _commands = new ConcurrentQueue<Action>();
+        private int _scheduled;
+
+        public void Post(CommandScheduler scheduler, Action command)
+        {
+            _commands.Enqueue(command);
+            if (Interlocked.CompareExchange(ref _scheduled, 1, 0) == 0) scheduler.Schedule(this);
+        }
+
+        public bool TryDequeue(out Action command)
+        {
+            return _commands.TryDequeue(out command);
+        }
+
+        public void Release(CommandScheduler scheduler)
+        {
+            Volatile.Write(ref _scheduled, 0);
+            if (!_commands.IsEmpty && Interlocked.CompareExchange(ref _scheduled, 1, 0) == 0) scheduler.Schedule(this);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Calibration;
+
+namespace YEISensorLib.Sharped.Async
+{
+    /// <summary>
+    /// Task based versions of the SensorDevice commands.
+    /// 
+    /// The API itself is blocking, so commands run on CommandScheduler's dedicated threads and never
+    /// occupy a thread pool thread for the serial turnaround. Unlike the synchronous methods they
+    /// return their values instead of updating the device's fields.
+    /// 
+    /// Cancelling or passing the timeout completes the task straight away. A command that has not
+    /// reached the device yet is skipped, one already on the wire finishes and its result is discarded.
+    /// </summary>
+    public static class SensorDeviceAsyncExtensions
+    {
+        public static Task<CommandResult<Quaternion>> GetQuaternionAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                Quaternion value;
+                uint timeStamp;
+                var result = ThreeSpaceInterop.GetTaredOrientationAsQuaternion(id, out value, out timeStamp);
+                return new CommandResult<Quaternion>(result, value, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<Euler>> GetEulerAnglesAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                Euler value;
+                uint timeStamp;
+                var result = ThreeSpaceInterop.GetTaredOrientationAsEulerAngles(id, out value, out timeStamp);
+                return new CommandResult<Euler>(result, value, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        /// <summary>
+        /// Reads the normalized gyro, accelerometer and compass into the matching fields of a sample.
+        /// </summary>
+        public static Task<CommandResult<SensorSample>> GetNormalizedSensorDataAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                var value = new SensorSample();
+                uint timeStamp;
+                var result = ThreeSpaceInterop.GetAllNormalizedComponentSensorData(id, out value.Gyro, out value.Accelerometer, out value.Compass, out timeStamp);
+                value.TimeStamp = timeStamp;
+                return new CommandResult<SensorSample>(result, value, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<ButtonState>> GetButtonStateAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                byte buttons;
+                uint timeStamp;
+                var result = ThreeSpaceInterop.GetButtonState(id, out buttons, out timeStamp);
+                return new CommandResult<ButtonState>(result, ButtonState.FromBitfield(buttons, timeStamp), timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<bool>> TareAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                uint timeStamp;
+                var result = ThreeSpaceInterop.TareWithCurrentOrientation(id, out timeStamp);
+                return new CommandResult<bool>(result, result == ResultEnum.NoError, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<bool>> SetLedColourAsync(this SensorDevice device, Color color, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                var result = ThreeSpaceInterop.SetLedColor(id, new[] { color.R, color.G, color.B }, 0);
+                return new CommandResult<bool>(result, result == ResultEnum.NoError, 0);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<Color>> GetLedColourAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                Color value;
+                uint timeStamp;
+                var result = ThreeSpaceInterop.GetLedColor(id, out value, out timeStamp);
+                return new CommandResult<Color>(result, value, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<GyroscopeCalibration>> GetGyroscopeCalibrationAsync(this SensorDevice device, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                var matrix = new float[9];
+                var bias = new float[3];
+                uint timeStamp;
+                var result = ThreeSpaceInterop.GetGyroscopeCalibrationCoefficients(id, matrix, bias, out timeStamp);
+                var value = result == ResultEnum.NoError ? new GyroscopeCalibration(matrix, new Vector3F { X = bias[0], Y = bias[1], Z = bias[2] }) : null;
+                return new CommandResult<GyroscopeCalibration>(result, value, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        public static Task<CommandResult<bool>> SetGyroscopeCalibrationAsync(this SensorDevice device, GyroscopeCalibration calibration, CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            return device.InvokeAsync(id =>
+            {
+                var bias = calibration.Bias;
+                uint timeStamp;
+                var result = ThreeSpaceInterop.SetGyroscopeCalibrationCoefficients(id, calibration.Matrix, new[] { bias.X, bias.Y, bias.Z }, out timeStamp);
+                return new CommandResult<bool>(result, result == ResultEnum.NoError, timeStamp);
+            }, cancellationToken, timeout);
+        }
+
+        /// <summary>
+        /// Run any ThreeSpaceInterop call for the device on the command scheduler.
+        /// </summary>
+        /// <param name="device">The sensor.</param>
+        /// <param name="command">Called with the device id on a command thread.</param>
+        /// <param name="cancellationToken">Cancels the command, the task is cancelled.</param>
+        /// <param name="timeout">Deadline for the command, the task completes with ResultEnum.ErrorTimeout once it passes.</param>
+        public static Task<CommandResult<T>> InvokeAsync<T>(this SensorDevice device, Func<uint, CommandResult<T>> command,
+                                                            CancellationToken cancellationToken = default(CancellationToken), TimeSpan? timeout = null)
+        {
+            var completion = new TaskCompletionSource<CommandResult<T>>();
+            if (!device.IsConnected || device.IsDongle)
+            {
+                completion.SetResult(new CommandResult<T>(ResultEnum.InvalidId, default(T), 0));
+                return completion.Task;
+            }
+            if (cancellationToken.IsCancellationRequested)
+            {
+                completion.SetCanceled();
+                return completion.Task;
+            }
+
+            var registration = cancellationToken.Register(() => completion.TrySetCanceled());
+            Timer deadline = null;
+            if (timeout != null && timeout.Value != Timeout.InfiniteTimeSpan)
+            {
+                deadline = new Timer(_ => completion.TrySetResult(new CommandResult<T>(ResultEnum.ErrorTimeout, default(T), 0)),
+                                     null, timeout.Value, Timeout.InfiniteTimeSpan);
+            }
+
+            device.CommandQueue.Post(CommandScheduler.Default, () =>
+            {
+                if (completion.Task.IsCompleted) return;
+                try
+                {
+                    var result = command(device.DeviceId);
+                    //Complete off the command thread so awaiting code never runs on it.
+                    ThreadPool.UnsafeQueueUserWorkItem(_ => completion.TrySetResult(result), null);
+                }
+                catch (Exception e)
+                {
+                    ThreadPool.UnsafeQueueUserWorkItem(_ => completion.TrySetException(e), null);
+                }
+            });
+
+            completion.Task.ContinueWith(_ =>
+            {
+                registration.Dispose();
+                if (deadline != null) deadline.Dispose();
+            }, TaskContinuationOptions.ExecuteSynchronously);
+            return completion.Task;
+        }
+    }
+}
@@ -0,0 +1,136 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Calibration
+{
+    /// <summary>
+    /// Online gyro bias of one sensor, learned from the stationary moments of its normal data.
+    /// 
+    /// Samples are taken in blocks. A block is stationary when the gyro barely varies, the accelerometer magnitude
+    /// is steady and the mean rate is small, its mean gyro is then a measurement of the bias. The first AveragedBlocks
+    /// measurements are averaged, later ones are blended in so the bias follows temperature drift.
+    /// Add is called by one thread, the bias can be read from any.
+    /// </summary>
+    public class GyroBiasEstimator
+    {
+        private readonly object _lock = new object();
+        private readonly GyroBiasEstimatorOptions _options;
+
+        private int _count;
+        private double _gx, _gy, _gz, _gxx, _gyy, _gzz, _a, _aa;
+
+        private Vector3F _bias;
+        private long _observations;
+        private long _blocks;
+        private bool _isStationary;
+
+        /// <summary>
+        /// Current estimate, to subtract from the gyro.
+        /// </summary>
+        public Vector3F Bias { get { lock (_lock) return _bias; } }
+
+        /// <summary>
+        /// Stationary blocks the estimate is made of.
+        /// </summary>
+        public long Observations { get { lock (_lock) return _observations; } }
+
+        public long Blocks { get { lock (_lock) return _blocks; } }
+
+        /// <summary>
+        /// True if the last complete block was stationary.
+        /// </summary>
+        public bool IsStationary { get { lock (_lock) return _isStationary; } }
+
+        /// <summary>
+        /// True once AveragedBlocks stationary blocks were seen.
+        /// </summary>
+        public bool IsConverged { get { lock (_lock) return _observations >= _options.AveragedBlocks; } }
+
+        public GyroBiasEstimator(GyroBiasEstimatorOptions options)
+        {
+            if (options.BlockSize < 2) throw new ArgumentOutOfRangeException("options", "BlockSize must be at least 2.");
+            _options = options;
+        }
+
+        /// <summary>
+        /// Add one sample of uncorrected gyro and accelerometer.
+        /// </summary>
+        /// <returns>True if this sample completed a stationary block and the bias was updated.</returns>
+        public bool Add(Vector3F gyro, Vector3F accelerometer)
+        {
+            var magnitude = Math.Sqrt(accelerometer.X * accelerometer.X + accelerometer.Y * accelerometer.Y + accelerometer.Z * accelerometer.Z);
+            _gx += gyro.X;
+            _gy += gyro.Y;
+            _gz += gyro.Z;
+            _gxx += gyro.X * gyro.X;
+            _gyy += gyro.Y * gyro.Y;
+            _gzz += gyro.Z * gyro.Z;
+            _a += magnitude;
+            _aa += magnitude * magnitude;
+            if (++_count < _options.BlockSize) return false;
+
+            var n = (double)_count;
+            var mean = new Vector3F { X = (float)(_gx / n), Y = (float)(_gy / n), Z = (float)(_gz / n) };
+            var maxGyroVariance = (double)_options.MaxGyroDeviation * _options.MaxGyroDeviation;
+            var maxAccelerometerVariance = (double)_options.MaxAccelerometerDeviation * _options.MaxAccelerometerDeviation;
+            var stationary = Variance(_gx, _gxx, n) <= maxGyroVariance
+                             && Variance(_gy, _gyy, n) <= maxGyroVariance
+                             && Variance(_gz, _gzz, n) <= maxGyroVariance
+                             && Variance(_a, _aa, n) <= maxAccelerometerVariance;
+            _count = 0;
+            _gx = _gy = _gz = _gxx = _gyy = _gzz = _a = _aa = 0;
+
+            lock (_lock)
+            {
+                _blocks++;
+                stationary = stationary
+                             && Math.Abs(mean.X - _bias.X) <= _options.MaxRate
+                             && Math.Abs(mean.Y - _bias.Y) <= _options.MaxRate
+                             && Math.Abs(mean.Z - _bias.Z) <= _options.MaxRate;
+                _isStationary = stationary;
+                if (!stationary) return false;
+
+                //Equal weights until converged, then an exponential moving average over AveragedBlocks.
+                _observations++;
+                var weight = 1f / Math.Min(_observations, Math.Max(1, _options.AveragedBlocks));
+                _bias.X += (mean.X - _bias.X) * weight;
+                _bias.Y += (mean.Y - _bias.Y) * weight;
+                _bias.Z += (mean.Z - _bias.Z) * weight;
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Remove part of the bias that is now corrected elsewhere, e.g. pushed to the sensor.
+        /// </summary>
+        public void Subtract(Vector3F corrected)
+        {
+            lock (_lock)
+            {
+                _bias.X -= corrected.X;
+                _bias.Y -= corrected.Y;
+                _bias.Z -= corrected.Z;
+            }
+        }
+
+        public void Reset()
+        {
+            lock (_lock)
+            {
+                _bias = new Vector3F();
+                _observations = 0;
+                _blocks = 0;
+                _isStationary = false;
+            }
+        }
+
+        private static double Variance(double sum, double sumOfSquares, double n)
+        {
+            return Math.Max(0, (sumOfSquares - sum * sum / n) / (n - 1));
+        }
+    }
+}
@@ -0,0 +1,50 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Calibration
+{
+    /// <summary>
+    /// When a block of samples counts as stationary, and how fast the bias follows. Rates in the gyro's units
+    /// (rad/s for corrected data), accelerations in the accelerometer's (g).
+    /// </summary>
+    public class GyroBiasEstimatorOptions
+    {
+        /// <summary>
+        /// Samples per block, e.g. half a second of data.
+        /// </summary>
+        public int BlockSize { get; set; }
+
+        /// <summary>
+        /// Largest gyro standard deviation, per axis, of a stationary block.
+        /// </summary>
+        public float MaxGyroDeviation { get; set; }
+
+        /// <summary>
+        /// Largest standard deviation of the accelerometer magnitude of a stationary block.
+        /// </summary>
+        public float MaxAccelerometerDeviation { get; set; }
+
+        /// <summary>
+        /// Largest mean rate of a stationary block, per axis, after the current bias.
+        /// Keeps a smooth, slow rotation (low deviation) from being taken for bias.
+        /// </summary>
+        public float MaxRate { get; set; }
+
+        /// <summary>
+        /// Stationary blocks averaged equally, afterwards the bias is a moving average over this many blocks, following drift.
+        /// </summary>
+        public int AveragedBlocks { get; set; }
+
+        public GyroBiasEstimatorOptions()
+        {
+            BlockSize = 50;
+            MaxGyroDeviation = 0.01f;
+            MaxAccelerometerDeviation = 0.01f;
+            MaxRate = 0.05f;
+            AveragedBlocks = 20;
+        }
+    }
+}
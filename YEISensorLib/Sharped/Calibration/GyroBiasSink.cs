@@ -0,0 +1,226 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Async;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Calibration
+{
+    /// <summary>
+    /// Keeps a GyroBiasEstimator per stream and gyro source and takes the bias out of the gyro of every sample.
+    /// 
+    /// Only packets carrying gyro feed an estimator. sample.Gyro holds the last gyro slot of the packet, as
+    /// StreamSlotLayout.Decode writes them in order, so that slot picks the estimator: raw and calibrated (normalized
+    /// or corrected) rates have different biases and are learnt apart. The correction is made on sample.Gyro, so sinks added after
+    /// this one see corrected rates, the payload bytes stay as the sensor sent them.
+    /// PushAsync moves the learnt bias into the sensors' own calibration, so the on-board filter profits too.
+    /// 
+    /// Usage:
+    ///     var bias = new GyroBiasSink();
+    ///     stream.AddSink(bias);    //Before the sinks that should see corrected gyro.
+    ///     ...
+    ///     bias.AllowPush = true;   //Optional, see PushAsync.
+    ///     await bias.PushAsync();  //Now and then, e.g. every minute.
+    /// </summary>
+    public class GyroBiasSink : IStreamSink
+    {
+        private readonly ConcurrentDictionary<SensorStream, GyroBiasEstimator> _estimators = new ConcurrentDictionary<SensorStream, GyroBiasEstimator>();
+        private readonly ConcurrentDictionary<SensorStream, GyroBiasEstimator> _rawEstimators = new ConcurrentDictionary<SensorStream, GyroBiasEstimator>();
+        private readonly ConcurrentDictionary<SensorStream, PushRecord> _pushes = new ConcurrentDictionary<SensorStream, PushRecord>();
+        private readonly ConcurrentDictionary<SensorStream, bool> _rolledBack = new ConcurrentDictionary<SensorStream, bool>();
+
+        public GyroBiasEstimatorOptions Options { get; private set; }
+
+        /// <summary>
+        /// Subtract the bias from sample.Gyro once it has been measured. On by default.
+        /// </summary>
+        public bool ApplyCorrection { get; set; }
+
+        /// <summary>
+        /// Smallest bias, per axis, PushAsync sends to a sensor. Smaller ones are only corrected on the host.
+        /// </summary>
+        public float MinimumPush { get; set; }
+
+        /// <summary>
+        /// Let PushAsync write sensor calibrations. Off by default, as the calibration convention it relies on is assumed.
+        /// </summary>
+        public bool AllowPush { get; set; }
+
+        /// <summary>
+        /// True if a push to the stream's sensor made the bias worse and was undone. No further pushes go to it.
+        /// </summary>
+        public bool IsRolledBack(SensorStream stream)
+        {
+            return _rolledBack.ContainsKey(stream);
+        }
+
+        public GyroBiasSink()
+            : this(new GyroBiasEstimatorOptions())
+        {
+        }
+
+        public GyroBiasSink(GyroBiasEstimatorOptions options)
+        {
+            Options = options;
+            ApplyCorrection = true;
+            MinimumPush = 0.001f;
+        }
+
+        /// <summary>
+        /// The stream's estimator of calibrated or raw gyro, or null before its first packet of that gyro.
+        /// </summary>
+        public GyroBiasEstimator Estimator(SensorStream stream, bool calibrated)
+        {
+            GyroBiasEstimator estimator;
+            return (calibrated ? _estimators : _rawEstimators).TryGetValue(stream, out estimator) ? estimator : null;
+        }
+
+        /// <summary>
+        /// Estimators of calibrated gyro, the ones PushAsync writes.
+        /// </summary>
+        public IDictionary<SensorStream, GyroBiasEstimator> Estimators
+        {
+            get { return _estimators.ToDictionary(p => p.Key, p => p.Value); }
+        }
+
+        /// <summary>
+        /// Estimators of raw gyro, corrected on the host only.
+        /// </summary>
+        public IDictionary<SensorStream, GyroBiasEstimator> RawEstimators
+        {
+            get { return _rawEstimators.ToDictionary(p => p.Key, p => p.Value); }
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            var source = GyroSlot(stream.PacketLayout);
+            if (source == StreamCommandEnum.Null) return;
+
+            var estimators = IsCalibrated(source) ? _estimators : _rawEstimators;
+            var estimator = estimators.GetOrAdd(stream, s => new GyroBiasEstimator(Options));
+            estimator.Add(sample.Gyro, sample.Accelerometer);
+            if (!ApplyCorrection || estimator.Observations == 0) return;
+
+            var bias = estimator.Bias;
+            sample.Gyro.X -= bias.X;
+            sample.Gyro.Y -= bias.Y;
+            sample.Gyro.Z -= bias.Z;
+        }
+
+        /// <summary>
+        /// Writes the bias of every converged stream into its sensor's calibration, all sensors at once.
+        /// Only streams of corrected or normalized gyro are pushed: the bias they show is what the sensor's
+        /// calibration left over. Commands go through the command scheduler, streaming carries on meanwhile.
+        /// 
+        /// The update assumes the sensor computes corrected = matrix * (raw - bias). A sensor is pushed to again only
+        /// once AveragedBlocks stationary blocks have been seen since its last push. If its bias grew meanwhile
+        /// the assumption does not hold for it: the previous calibration is restored and the sensor is left alone.
+        /// </summary>
+        /// <returns>The number of sensors updated.</returns>
+        public async Task<int> PushAsync()
+        {
+            if (!AllowPush) throw new InvalidOperationException("Set AllowPush to write sensor calibrations.");
+
+            var pushes = _estimators.Where(p => p.Value.IsConverged && !_rolledBack.ContainsKey(p.Key))
+                                    .Select(p => Push(p.Key, p.Value))
+                                    .ToArray();
+            var results = await Task.WhenAll(pushes);
+            return results.Count(r => r);
+        }
+
+        private async Task<bool> Push(SensorStream stream, GyroBiasEstimator estimator)
+        {
+            var device = stream.Device;
+            PushRecord last;
+            if (_pushes.TryGetValue(stream, out last))
+            {
+                if (estimator.Observations - last.Observations < Options.AveragedBlocks) return false;
+                if (Magnitude(estimator.Bias) > Magnitude(last.Residual))
+                {
+                    var restored = await device.SetGyroscopeCalibrationAsync(last.Previous);
+                    if (!restored.Success) return false;
+                    //The sensor is back to the old residual, which the estimator measured on top of the pushed one.
+                    estimator.Subtract(last.Residual);
+                    _rolledBack[stream] = true;
+                    _pushes.TryRemove(stream, out last);
+                    return false;
+                }
+            }
+
+            var residual = estimator.Bias;
+            if (Math.Abs(residual.X) < MinimumPush && Math.Abs(residual.Y) < MinimumPush && Math.Abs(residual.Z) < MinimumPush) return false;
+
+            var calibration = await device.GetGyroscopeCalibrationAsync();
+            if (!calibration.Success) return false;
+
+            //Taken off the host correction before the write, so no sample is corrected twice.
+            estimator.Subtract(residual);
+            var written = await device.SetGyroscopeCalibrationAsync(calibration.Value.WithResidual(residual));
+            if (!written.Success)
+            {
+                estimator.Subtract(new Vector3F { X = -residual.X, Y = -residual.Y, Z = -residual.Z });
+                return false;
+            }
+
+            _pushes[stream] = new PushRecord(calibration.Value, residual, estimator.Observations);
+            return true;
+        }
+
+        private static double Magnitude(Vector3F value)
+        {
+            return Math.Sqrt(value.X * value.X + value.Y * value.Y + value.Z * value.Z);
+        }
+
+        /// <summary>
+        /// The slot sample.Gyro was decoded from: the last one carrying gyro. Null if none does.
+        /// </summary>
+        private static StreamCommandEnum GyroSlot(StreamSlotLayout layout)
+        {
+            for (var slot = layout.Slots.Length - 1; slot >= 0; slot--)
+            {
+                switch (layout.Slots[slot])
+                {
+                    case StreamCommandEnum.AllNormalizedComponentSensorData:
+                    case StreamCommandEnum.AllCorrectedComponentSensorData:
+                    case StreamCommandEnum.AllRawComponentSensorData:
+                    case StreamCommandEnum.NormalizedGyroRate:
+                    case StreamCommandEnum.CorrectedGyroRate:
+                    case StreamCommandEnum.RawGyroscopeRate:
+                        return layout.Slots[slot];
+                }
+            }
+            return StreamCommandEnum.Null;
+        }
+
+        private static bool IsCalibrated(StreamCommandEnum gyroSlot)
+        {
+            return gyroSlot != StreamCommandEnum.AllRawComponentSensorData && gyroSlot != StreamCommandEnum.RawGyroscopeRate;
+        }
+
+        private class PushRecord
+        {
+            /// <summary>
+            /// The calibration before the push, restored if the push made things worse.
+            /// </summary>
+            public readonly GyroscopeCalibration Previous;
+
+            public readonly Vector3F Residual;
+
+            /// <summary>
+            /// Estimator observations at the push.
+            /// </summary>
+            public readonly long Observations;
+
+            public PushRecord(GyroscopeCalibration previous, Vector3F residual, long observations)
+            {
+                Previous = previous;
+                Residual = residual;
+                Observations = observations;
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Calibration
+{
+    /// <summary>
+    /// The sensor's gyroscope calibration, taken as corrected = Matrix * (raw - Bias).
+    /// </summary>
+    public class GyroscopeCalibration
+    {
+        /// <summary>
+        /// 3x3 scale matrix, row major.
+        /// </summary>
+        public float[] Matrix { get; private set; }
+
+        public Vector3F Bias { get; set; }
+
+        public GyroscopeCalibration(float[] matrix, Vector3F bias)
+        {
+            if (matrix == null || matrix.Length != 9) throw new ArgumentOutOfRangeException("matrix", "Matrix must have 9 values.");
+            Matrix = matrix;
+            Bias = bias;
+        }
+
+        /// <summary>
+        /// The calibration with a bias still seen in corrected data moved into Bias.
+        /// </summary>
+        /// <param name="residual">Mean corrected rate at rest.</param>
+        public GyroscopeCalibration WithResidual(Vector3F residual)
+        {
+            //Residual = M * (trueBias - Bias), so Bias moves by M^-1 * residual.
+            var m = Matrix;
+            var c0 = m[4] * m[8] - m[5] * m[7];
+            var c1 = m[5] * m[6] - m[3] * m[8];
+            var c2 = m[3] * m[7] - m[4] * m[6];
+            var determinant = m[0] * c0 + m[1] * c1 + m[2] * c2;
+            if (Math.Abs(determinant) < 1e-12f) throw new InvalidOperationException("The calibration matrix is singular.");
+
+            var x = (c0 * residual.X + (m[2] * m[7] - m[1] * m[8]) * residual.Y + (m[1] * m[5] - m[2] * m[4]) * residual.Z) / determinant;
+            var y = (c1 * residual.X + (m[0] * m[8] - m[2] * m[6]) * residual.Y + (m[2] * m[3] - m[0] * m[5]) * residual.Z) / determinant;
+            var z = (c2 * residual.X + (m[1] * m[6] - m[0] * m[7]) * residual.Y + (m[0] * m[4] - m[1] * m[3]) * residual.Z) / determinant;
+            var bias = Bias;
+            return new GyroscopeCalibration((float[])Matrix.Clone(), new Vector3F { X = bias.X + x, Y = bias.Y + y, Z = bias.Z + z });
+        }
+    }
+}
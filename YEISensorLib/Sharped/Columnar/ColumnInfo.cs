@@ -0,0 +1,114 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// One column of a columnar session file.
+    /// Every file starts with the Time and TimeStamp columns, followed by one column per value of each streamed slot,
+    /// named after the command, e.g. "TaredOrientationAsQuaternion.W" or "AllNormalizedComponentSensorData.GyroX".
+    /// </summary>
+    public class ColumnInfo
+    {
+        /// <summary>
+        /// UTC DateTime ticks of each row, as long.
+        /// </summary>
+        public const string Time = "Time";
+
+        /// <summary>
+        /// Sensor timestamp (microseconds, wraps around) of each row, as uint.
+        /// </summary>
+        public const string TimeStamp = "TimeStamp";
+
+        private static readonly string[] QuaternionNames = { "X", "Y", "Z", "W" };
+        private static readonly string[] AxisAngleNames = { "X", "Y", "Z", "Angle" };
+        private static readonly string[] VectorNames = { "X", "Y", "Z" };
+        private static readonly string[] TwoVectorNames = { "X1", "Y1", "Z1", "X2", "Y2", "Z2" };
+        private static readonly string[] MatrixNames = { "M11", "M12", "M13", "M21", "M22", "M23", "M31", "M32", "M33" };
+        private static readonly string[] ComponentNames = { "GyroX", "GyroY", "GyroZ", "AccelerometerX", "AccelerometerY", "AccelerometerZ", "CompassX", "CompassY", "CompassZ" };
+
+        public string Name { get; private set; }
+
+        /// <summary>
+        /// Size in bytes of one value: 8 for Time, 1 for byte valued slots, 4 otherwise (uint TimeStamp or float).
+        /// </summary>
+        public int ElementSize { get; private set; }
+
+        /// <summary>
+        /// The slot the column is read from, Null for Time and TimeStamp.
+        /// </summary>
+        public StreamCommandEnum Command { get; private set; }
+
+        /// <summary>
+        /// Byte offset of the value within a stream packet, -1 for Time and TimeStamp.
+        /// </summary>
+        public int PayloadOffset { get; private set; }
+
+        public ColumnInfo(string name, int elementSize, StreamCommandEnum command, int payloadOffset)
+        {
+            Name = name;
+            ElementSize = elementSize;
+            Command = command;
+            PayloadOffset = payloadOffset;
+        }
+
+        /// <summary>
+        /// The columns of a file holding packets of the layout.
+        /// </summary>
+        public static ColumnInfo[] ForLayout(StreamSlotLayout layout)
+        {
+            var columns = new List<ColumnInfo>
+                              {
+                                  new ColumnInfo(Time, 8, StreamCommandEnum.Null, -1),
+                                  new ColumnInfo(TimeStamp, 4, StreamCommandEnum.Null, -1),
+                              };
+            for (var slot = 0; slot < layout.Slots.Length; slot++)
+            {
+                var command = layout.Slots[slot];
+                var count = StreamSlotLayout.ValueCount(command);
+                var size = StreamSlotLayout.IsByteValued(command) ? 1 : 4;
+                var names = ValueNames(command);
+                for (var value = 0; value < count; value++)
+                {
+                    var name = count == 1 ? command.ToString()
+                               : command + "." + (names != null && names.Length == count ? names[value] : value.ToString());
+                    columns.Add(new ColumnInfo(name, size, command, layout.OffsetOfSlot(slot) + value * size));
+                }
+            }
+            return columns.ToArray();
+        }
+
+        private static string[] ValueNames(StreamCommandEnum command)
+        {
+            switch (command)
+            {
+                case StreamCommandEnum.TaredOrientationAsQuaternion:
+                case StreamCommandEnum.UntaredOrientationAsQuaternion:
+                case StreamCommandEnum.DifferenceQuaternion:
+                    return QuaternionNames;
+                case StreamCommandEnum.TaredOrientationAsAxisAngle:
+                case StreamCommandEnum.UntaredOrientationAsAxisAngle:
+                    return AxisAngleNames;
+                case StreamCommandEnum.TaredOrientationAsRotationMatrix:
+                case StreamCommandEnum.UntaredOrientationAsRotationMatrix:
+                    return MatrixNames;
+                case StreamCommandEnum.AllNormalizedComponentSensorData:
+                case StreamCommandEnum.AllCorrectedComponentSensorData:
+                case StreamCommandEnum.AllRawComponentSensorData:
+                    return ComponentNames;
+                case StreamCommandEnum.TaredOrientationAsTwoVector:
+                case StreamCommandEnum.UntaredOrientationAsTwoVector:
+                case StreamCommandEnum.TaredTwoVectorInSensorFrame:
+                case StreamCommandEnum.UntaredTwoVectorInSensorFrame:
+                    return TwoVectorNames;
+                default:
+                    return VectorNames;
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// Matching rows of one row group, as one array per requested column.
+    /// </summary>
+    public class ColumnarBatch
+    {
+        private readonly Dictionary<string, Array> _columns = new Dictionary<string, Array>();
+
+        public uint SerialNumber { get; private set; }
+
+        public int RowCount { get; private set; }
+
+        /// <summary>
+        /// UTC ticks of each row.
+        /// </summary>
+        public long[] Times { get; private set; }
+
+        internal ColumnarBatch(uint serialNumber, long[] times)
+        {
+            SerialNumber = serialNumber;
+            Times = times;
+            RowCount = times.Length;
+        }
+
+        internal void Add(string name, Array values)
+        {
+            _columns[name] = values;
+        }
+
+        public bool HasColumn(string name)
+        {
+            return _columns.ContainsKey(name);
+        }
+
+        /// <summary>
+        /// Sensor timestamps, null unless the TimeStamp column was requested.
+        /// </summary>
+        public uint[] TimeStamps
+        {
+            get { return Get(ColumnInfo.TimeStamp) as uint[]; }
+        }
+
+        /// <summary>
+        /// Values of a float column, null if it was not read.
+        /// </summary>
+        public float[] GetFloats(string name)
+        {
+            return Get(name) as float[];
+        }
+
+        /// <summary>
+        /// Values of a byte column (battery, buttons), null if it was not read.
+        /// </summary>
+        public byte[] GetBytes(string name)
+        {
+            return Get(name) as byte[];
+        }
+
+        private Array Get(string name)
+        {
+            Array values;
+            return _columns.TryGetValue(name, out values) ? values : null;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Recording;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// Reads a columnar session file. Only the footer is read on open, column chunks are read on demand.
+    /// </summary>
+    public class ColumnarFile : IDisposable
+    {
+        private const int BufferSize = 1 << 16;
+        private const int TrailerSize = 12;
+        private const int RowGroupEntrySize = 28;
+
+        private bool _isDisposed;
+
+        private readonly FileStream _stream;
+        private readonly BinaryReader _reader;
+        private readonly List<RowGroupInfo> _rowGroups = new List<RowGroupInfo>();
+
+        /// <summary>
+        /// Returns true if the file is a complete columnar file this version can read.
+        /// </summary>
+        public bool IsValid { get; private set; }
+
+        public SessionLogHeader Header { get; private set; }
+
+        public ColumnInfo[] Columns { get; private set; }
+
+        public IList<RowGroupInfo> RowGroups { get; private set; }
+
+        /// <summary>
+        /// Bytes read from the file so far, including the footer.
+        /// </summary>
+        public long BytesRead { get; private set; }
+
+        public ColumnarFile(string path)
+        {
+            //Chunks are read with random access, keep the OS buffer small.
+            _stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, BufferSize, FileOptions.RandomAccess);
+            _reader = new BinaryReader(_stream);
+            RowGroups = new ReadOnlyCollection<RowGroupInfo>(_rowGroups);
+
+            if (_stream.Length < 8 + TrailerSize || _reader.ReadInt32() != ColumnarFileWriter.Magic || _reader.ReadInt32() != ColumnarFileWriter.Version) return;
+            Header = SessionLogHeader.Read(_reader);
+            if (Header == null) return;
+            Columns = ColumnInfo.ForLayout(Header.Layout);
+            var dataStart = _stream.Position;
+
+            _stream.Position = _stream.Length - TrailerSize;
+            var footerOffset = _reader.ReadInt64();
+            if (_reader.ReadInt32() != ColumnarFileWriter.Magic || footerOffset < dataStart || footerOffset > _stream.Length - TrailerSize - 4) return;
+
+            _stream.Position = footerOffset;
+            var count = _reader.ReadInt32();
+            if (count < 0 || footerOffset + 4 + (long)count * RowGroupEntrySize != _stream.Length - TrailerSize) return;
+            for (var i = 0; i < count; i++)
+            {
+                _rowGroups.Add(new RowGroupInfo
+                                   {
+                                       Offset = _reader.ReadInt64(),
+                                       RowCount = _reader.ReadInt32(),
+                                       MinTime = _reader.ReadInt64(),
+                                       MaxTime = _reader.ReadInt64(),
+                                   });
+            }
+            BytesRead = _stream.Length - footerOffset + dataStart;
+            IsValid = true;
+        }
+
+        /// <summary>
+        /// Index of a column by name, -1 if the file has no such column.
+        /// </summary>
+        public int ColumnIndex(string name)
+        {
+            for (var i = 0; i < Columns.Length; i++)
+            {
+                if (Columns[i].Name == name) return i;
+            }
+            return -1;
+        }
+
+        /// <summary>
+        /// Read rows [firstRow, firstRow + rowCount) of a column chunk.
+        /// </summary>
+        /// <param name="rowGroup">Index into RowGroups.</param>
+        /// <param name="column">Index into Columns.</param>
+        /// <param name="firstRow">First row within the row group.</param>
+        /// <param name="rowCount">Number of rows.</param>
+        /// <param name="buffer">Receives the raw values, must hold rowCount * ElementSize bytes.</param>
+        public void ReadColumn(int rowGroup, int column, int firstRow, int rowCount, byte[] buffer)
+        {
+            var group = _rowGroups[rowGroup];
+            var offset = group.Offset;
+            for (var c = 0; c < column; c++) offset += (long)group.RowCount * Columns[c].ElementSize;
+            var size = Columns[column].ElementSize;
+
+            _stream.Position = offset + (long)firstRow * size;
+            var bytes = rowCount * size;
+            var read = 0;
+            while (read < bytes)
+            {
+                var n = _stream.Read(buffer, read, bytes - read);
+                if (n == 0) throw new EndOfStreamException();
+                read += n;
+            }
+            BytesRead += bytes;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            _reader.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
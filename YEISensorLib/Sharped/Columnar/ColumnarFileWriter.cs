@@ -0,0 +1,149 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Recording;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// Writes the records of one session as a columnar file (.ycl).
+    /// 
+    /// File layout:
+    ///     int Magic, int Version, the SessionLogHeader,
+    ///     row groups: one chunk per column (see ColumnInfo.ForLayout), RowCount values back to back,
+    ///     footer: int RowGroupCount, per row group long Offset, int RowCount, long MinTime, long MaxTime,
+    ///     long FooterOffset, int Magic.
+    /// Sensor timestamps are unwrapped and converted to UTC ticks from the session start for the Time column.
+    /// </summary>
+    public class ColumnarFileWriter : IDisposable
+    {
+        public const int Magic = 0x314c4359; //"YCL1"
+        public const int Version = 1;
+
+        private const int BufferSize = 1 << 20;
+
+        private bool _isDisposed;
+
+        private readonly FileStream _stream;
+        private readonly BinaryWriter _writer;
+        private readonly ColumnInfo[] _columns;
+        private readonly byte[][] _chunks;
+        private readonly long[] _times;
+        private readonly int _rowGroupSize;
+        private readonly List<RowGroupInfo> _rowGroups = new List<RowGroupInfo>();
+        private int _rows;
+
+        private readonly long _startTicks;
+        private long _elapsedMicroseconds;
+        private uint _lastTimeStamp;
+        private bool _hasTimeStamp;
+
+        public SessionLogHeader Header { get; private set; }
+
+        public long RowCount { get; private set; }
+
+        /// <summary>
+        /// UTC ticks of the first row.
+        /// </summary>
+        public long MinTime { get; private set; }
+
+        /// <summary>
+        /// UTC ticks of the last row.
+        /// </summary>
+        public long MaxTime { get; private set; }
+
+        /// <param name="path">File to create, overwritten if it exists.</param>
+        /// <param name="header">Serial number and layout of the session.</param>
+        /// <param name="sessionStartUtc">Time of the session's first record.</param>
+        /// <param name="rowGroupSize">Rows per row group, the unit of skipping.</param>
+        public ColumnarFileWriter(string path, SessionLogHeader header, DateTime sessionStartUtc, int rowGroupSize)
+        {
+            if (rowGroupSize <= 0) throw new ArgumentOutOfRangeException("rowGroupSize");
+
+            Header = header;
+            _rowGroupSize = rowGroupSize;
+            _startTicks = sessionStartUtc.ToUniversalTime().Ticks;
+            _columns = ColumnInfo.ForLayout(header.Layout);
+            _chunks = _columns.Select(c => new byte[rowGroupSize * c.ElementSize]).ToArray();
+            _times = new long[rowGroupSize];
+
+            _stream = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.None, BufferSize, FileOptions.SequentialScan);
+            _writer = new BinaryWriter(_stream);
+            _writer.Write(Magic);
+            _writer.Write(Version);
+            header.Write(_writer);
+        }
+
+        /// <summary>
+        /// Append session log records (timestamp followed by payload).
+        /// </summary>
+        public void WriteRecords(byte[] records, int offset, int count)
+        {
+            var recordSize = Header.RecordSize;
+            for (var i = 0; i < count; i++, offset += recordSize)
+            {
+                var timeStamp = BitConverter.ToUInt32(records, offset);
+                if (_hasTimeStamp) _elapsedMicroseconds += SensorClock.ElapsedMicroseconds(_lastTimeStamp, timeStamp);
+                _lastTimeStamp = timeStamp;
+                _hasTimeStamp = true;
+
+                _times[_rows] = _startTicks + _elapsedMicroseconds * 10;
+                Buffer.BlockCopy(records, offset, _chunks[1], _rows * 4, 4);
+                for (var c = 2; c < _columns.Length; c++)
+                {
+                    var column = _columns[c];
+                    Buffer.BlockCopy(records, offset + 4 + column.PayloadOffset, _chunks[c], _rows * column.ElementSize, column.ElementSize);
+                }
+
+                if (++_rows == _rowGroupSize) WriteRowGroup();
+            }
+        }
+
+        private void WriteRowGroup()
+        {
+            if (_rows == 0) return;
+
+            var group = new RowGroupInfo
+                            {
+                                Offset = _stream.Position,
+                                RowCount = _rows,
+                                MinTime = _times[0],
+                                MaxTime = _times[_rows - 1],
+                            };
+            Buffer.BlockCopy(_times, 0, _chunks[0], 0, _rows * 8);
+            for (var c = 0; c < _columns.Length; c++) _writer.Write(_chunks[c], 0, _rows * _columns[c].ElementSize);
+
+            if (_rowGroups.Count == 0) MinTime = group.MinTime;
+            MaxTime = group.MaxTime;
+            RowCount += _rows;
+            _rowGroups.Add(group);
+            _rows = 0;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            WriteRowGroup();
+
+            var footerOffset = _stream.Position;
+            _writer.Write(_rowGroups.Count);
+            foreach (var group in _rowGroups)
+            {
+                _writer.Write(group.Offset);
+                _writer.Write(group.RowCount);
+                _writer.Write(group.MinTime);
+                _writer.Write(group.MaxTime);
+            }
+            _writer.Write(footerOffset);
+            _writer.Write(Magic);
+
+            _writer.Flush();
+            _writer.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
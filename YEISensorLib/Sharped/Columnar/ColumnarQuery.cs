@@ -0,0 +1,52 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// Filters and projection of a ColumnarStore scan. Unset properties do not filter.
+    /// </summary>
+    public class ColumnarQuery
+    {
+        /// <summary>
+        /// First time included (UTC).
+        /// </summary>
+        public DateTime? From { get; set; }
+
+        /// <summary>
+        /// First time excluded (UTC).
+        /// </summary>
+        public DateTime? To { get; set; }
+
+        /// <summary>
+        /// Sensors to include, by serial number.
+        /// </summary>
+        public ICollection<uint> SerialNumbers { get; set; }
+
+        /// <summary>
+        /// Columns to read, by ColumnInfo name. Time is always read. Files lacking a column return batches without it.
+        /// </summary>
+        public ICollection<string> Columns { get; set; }
+
+        internal long FromTicks
+        {
+            get { return From.HasValue ? From.Value.ToUniversalTime().Ticks : long.MinValue; }
+        }
+
+        internal long ToTicks
+        {
+            get { return To.HasValue ? To.Value.ToUniversalTime().Ticks : long.MaxValue; }
+        }
+
+        /// <summary>
+        /// True if any time in [minTime, maxTime] can match.
+        /// </summary>
+        internal bool Overlaps(long minTime, long maxTime)
+        {
+            return maxTime >= FromTicks && minTime < ToTicks;
+        }
+    }
+}
@@ -0,0 +1,147 @@
+﻿using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// Enumerates the batches matching a query, pruning as early as possible:
+    ///     partitions (serial numbers) by directory name,
+    ///     files by the time range in their name,
+    ///     row groups by their footer statistics,
+    ///     rows by binary search on Time, in the row groups crossing a range boundary.
+    /// Only requested columns are read. The counters show how much was skipped.
+    /// </summary>
+    public class ColumnarScan : IEnumerable<ColumnarBatch>
+    {
+        private readonly ColumnarStore _store;
+        private readonly ColumnarQuery _query;
+
+        public long PartitionsSkipped { get; private set; }
+        public long FilesSkipped { get; private set; }
+        public long FilesRead { get; private set; }
+        public long RowGroupsSkipped { get; private set; }
+        public long RowGroupsRead { get; private set; }
+        public long RowsReturned { get; private set; }
+        public long BytesRead { get; private set; }
+
+        internal ColumnarScan(ColumnarStore store, ColumnarQuery query)
+        {
+            _store = store;
+            _query = query;
+        }
+
+        public IEnumerator<ColumnarBatch> GetEnumerator()
+        {
+            if (!Directory.Exists(_store.Root)) yield break;
+
+            foreach (var partition in Directory.GetDirectories(_store.Root).OrderBy(d => d, StringComparer.OrdinalIgnoreCase))
+            {
+                uint serialNumber;
+                if (!uint.TryParse(Path.GetFileName(partition), NumberStyles.HexNumber, CultureInfo.InvariantCulture, out serialNumber)) continue;
+                if (_query.SerialNumbers != null && !_query.SerialNumbers.Contains(serialNumber))
+                {
+                    PartitionsSkipped++;
+                    continue;
+                }
+
+                foreach (var path in Directory.GetFiles(partition, "*" + ColumnarStore.Extension).OrderBy(f => f, StringComparer.OrdinalIgnoreCase))
+                {
+                    long minTime, maxTime;
+                    if (ColumnarStore.TryParseFileName(path, out minTime, out maxTime) && !_query.Overlaps(minTime, maxTime))
+                    {
+                        FilesSkipped++;
+                        continue;
+                    }
+
+                    using (var file = new ColumnarFile(path))
+                    {
+                        if (!file.IsValid) continue;
+                        FilesRead++;
+                        for (var group = 0; group < file.RowGroups.Count; group++)
+                        {
+                            var info = file.RowGroups[group];
+                            if (!_query.Overlaps(info.MinTime, info.MaxTime))
+                            {
+                                RowGroupsSkipped++;
+                                continue;
+                            }
+                            RowGroupsRead++;
+
+                            var batch = ReadRowGroup(file, group, serialNumber);
+                            if (batch == null) continue;
+                            RowsReturned += batch.RowCount;
+                            yield return batch;
+                        }
+                        BytesRead += file.BytesRead;
+                    }
+                }
+            }
+        }
+
+        private ColumnarBatch ReadRowGroup(ColumnarFile file, int group, uint serialNumber)
+        {
+            var info = file.RowGroups[group];
+            var buffer = new byte[info.RowCount * 8];
+            file.ReadColumn(group, 0, 0, info.RowCount, buffer);
+            var times = new long[info.RowCount];
+            Buffer.BlockCopy(buffer, 0, times, 0, buffer.Length);
+
+            //Time only grows within a session, so matching rows are contiguous.
+            int first = 0, end = info.RowCount;
+            if (info.MinTime < _query.FromTicks) first = LowerBound(times, _query.FromTicks);
+            if (info.MaxTime >= _query.ToTicks) end = LowerBound(times, _query.ToTicks);
+            if (first >= end) return null;
+
+            if (first > 0 || end < times.Length)
+            {
+                var slice = new long[end - first];
+                Array.Copy(times, first, slice, 0, slice.Length);
+                times = slice;
+            }
+            var batch = new ColumnarBatch(serialNumber, times);
+
+            var names = _query.Columns ?? file.Columns.Select(c => c.Name).ToArray();
+            foreach (var name in names)
+            {
+                var column = file.ColumnIndex(name);
+                if (column <= 0) continue;
+
+                var columnInfo = file.Columns[column];
+                var bytes = (end - first) * columnInfo.ElementSize;
+                if (buffer.Length < bytes) buffer = new byte[bytes];
+                file.ReadColumn(group, column, first, end - first, buffer);
+
+                Array values;
+                if (columnInfo.ElementSize == 1) values = new byte[end - first];
+                else if (columnInfo.Name == ColumnInfo.TimeStamp) values = new uint[end - first];
+                else values = new float[end - first];
+                Buffer.BlockCopy(buffer, 0, values, 0, bytes);
+                batch.Add(name, values);
+            }
+            return batch;
+        }
+
+        private static int LowerBound(long[] times, long value)
+        {
+            int low = 0, high = times.Length;
+            while (low < high)
+            {
+                var middle = (low + high) / 2;
+                if (times[middle] < value) low = middle + 1;
+                else high = middle;
+            }
+            return low;
+        }
+
+        IEnumerator IEnumerable.GetEnumerator()
+        {
+            return GetEnumerator();
+        }
+    }
+}
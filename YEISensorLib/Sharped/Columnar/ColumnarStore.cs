@@ -0,0 +1,116 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Recording;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// A directory of columnar session files, partitioned by sensor serial number:
+    ///     Root\{serial:X8}\{first time:X16}-{last time:X16}.ycl
+    /// File names carry each file's time range (UTC ticks), so scans skip files without opening them.
+    /// 
+    /// Usage:
+    ///     var store = new ColumnarStore(@"C:\Sessions\Columnar");
+    ///     using (var log = new SessionLogReader(path)) store.Export(log, sessionStartUtc);
+    ///     foreach (var batch in store.Scan(new ColumnarQuery { From = from, To = to, Columns = new[] { "TaredOrientationAsQuaternion.W" } })) ...
+    /// </summary>
+    public class ColumnarStore
+    {
+        public const string Extension = ".ycl";
+
+        private const int ReadBatchRecords = 16384;
+
+        public string Root { get; private set; }
+
+        /// <summary>
+        /// Rows per row group of exported files.
+        /// </summary>
+        public int RowGroupSize { get; set; }
+
+        public ColumnarStore(string root)
+        {
+            Root = root;
+            RowGroupSize = 65536;
+        }
+
+        /// <summary>
+        /// Serial numbers of the sensors with a partition.
+        /// </summary>
+        public uint[] SerialNumbers
+        {
+            get
+            {
+                if (!Directory.Exists(Root)) return new uint[0];
+                var serials = new List<uint>();
+                foreach (var partition in Directory.GetDirectories(Root))
+                {
+                    uint serial;
+                    if (uint.TryParse(Path.GetFileName(partition), NumberStyles.HexNumber, CultureInfo.InvariantCulture, out serial)) serials.Add(serial);
+                }
+                return serials.ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Export a session log (plain or compressed) into the sensor's partition.
+        /// </summary>
+        /// <param name="log">The session, read from its current position to the end.</param>
+        /// <param name="sessionStartUtc">Time of the session's first record.</param>
+        /// <returns>Path of the new file, null if the log is invalid or empty.</returns>
+        public string Export(ISessionLogReader log, DateTime sessionStartUtc)
+        {
+            if (!log.IsValid) return null;
+            var header = log.Header;
+            var partition = Path.Combine(Root, header.SerialNumber.ToString("X8"));
+            Directory.CreateDirectory(partition);
+
+            var temporary = Path.Combine(partition, Guid.NewGuid().ToString("N") + ".tmp");
+            ColumnarFileWriter writer;
+            using (writer = new ColumnarFileWriter(temporary, header, sessionStartUtc, RowGroupSize))
+            {
+                var buffer = new byte[ReadBatchRecords * header.RecordSize];
+                int count;
+                while ((count = log.ReadRecords(buffer)) > 0) writer.WriteRecords(buffer, 0, count);
+            }
+
+            if (writer.RowCount == 0)
+            {
+                File.Delete(temporary);
+                return null;
+            }
+
+            //The name is only given once the file is complete, scans never see a partial file.
+            var path = Path.Combine(partition, FileName(writer.MinTime, writer.MaxTime));
+            if (File.Exists(path)) File.Delete(path);
+            File.Move(temporary, path);
+            return path;
+        }
+
+        /// <summary>
+        /// Scan the files matching the query. Enumerating the result performs the scan.
+        /// </summary>
+        public ColumnarScan Scan(ColumnarQuery query)
+        {
+            return new ColumnarScan(this, query);
+        }
+
+        public static string FileName(long minTime, long maxTime)
+        {
+            return minTime.ToString("X16") + "-" + maxTime.ToString("X16") + Extension;
+        }
+
+        public static bool TryParseFileName(string path, out long minTime, out long maxTime)
+        {
+            minTime = maxTime = 0;
+            var parts = Path.GetFileNameWithoutExtension(path).Split('-');
+            return parts.Length == 2
+                   && long.TryParse(parts[0], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out minTime)
+                   && long.TryParse(parts[1], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out maxTime);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Columnar
+{
+    /// <summary>
+    /// Footer entry of one row group: where its column chunks start and the time range it covers.
+    /// </summary>
+    public struct RowGroupInfo
+    {
+        /// <summary>
+        /// File offset of the first column chunk, the others follow in column order.
+        /// </summary>
+        public long Offset;
+
+        public int RowCount;
+
+        /// <summary>
+        /// UTC ticks of the first row.
+        /// </summary>
+        public long MinTime;
+
+        /// <summary>
+        /// UTC ticks of the last row.
+        /// </summary>
+        public long MaxTime;
+    }
+}
@@ -0,0 +1,38 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Configuration
+{
+    /// <summary>
+    /// What applying a profile to one sensor did.
+    /// </summary>
+    public class ConfigurationApplyResult
+    {
+        public uint SerialNumber { get; set; }
+
+        /// <summary>
+        /// True if the current settings came from the cache instead of the device.
+        /// </summary>
+        public bool UsedCache { get; set; }
+
+        /// <summary>
+        /// The settings that differed from the profile and were written.
+        /// </summary>
+        public SensorConfiguration Changes { get; set; }
+
+        public int SettingsWritten { get; set; }
+
+        /// <summary>
+        /// True if tss_commitSettings was called.
+        /// </summary>
+        public bool Committed { get; set; }
+
+        /// <summary>
+        /// False if the device could not be read or a write failed.
+        /// </summary>
+        public bool Success { get; set; }
+    }
+}
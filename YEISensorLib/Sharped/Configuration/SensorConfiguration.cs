@@ -0,0 +1,207 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Configuration
+{
+    /// <summary>
+    /// A set of sensor settings.
+    /// A snapshot read from a device has every supported setting filled in,
+    /// a desired profile only sets the settings it cares about (null means "leave as is").
+    /// </summary>
+    public class SensorConfiguration
+    {
+        private const float Tolerance = 1e-6f;
+
+        public FilterModeEnum? FilterMode { get; set; }
+        public byte? AccelerometerRange { get; set; }
+        public byte? GyroscopeRange { get; set; }
+        public byte? CompassRange { get; set; }
+        public float? AccelerometerMinTrust { get; set; }
+        public float? AccelerometerMaxTrust { get; set; }
+        public float? CompassMinTrust { get; set; }
+        public float? CompassMaxTrust { get; set; }
+
+        /// <summary>
+        /// Axis direction byte, see tss_generateAxisDirections.
+        /// </summary>
+        public byte? AxisDirections { get; set; }
+
+        /// <summary>
+        /// Desired filter update period in microseconds.
+        /// </summary>
+        public uint? DesiredUpdateRate { get; set; }
+
+        public float? RunningAveragePercent { get; set; }
+        public Color? LedColor { get; set; }
+
+        /// <summary>
+        /// Firmware version the snapshot was read from, a firmware update invalidates cached snapshots.
+        /// </summary>
+        public string FirmwareVersion { get; set; }
+
+        /// <summary>
+        /// True if no setting is set.
+        /// </summary>
+        public bool IsEmpty
+        {
+            get
+            {
+                return FilterMode == null && AccelerometerRange == null && GyroscopeRange == null && CompassRange == null
+                       && AccelerometerMinTrust == null && AccelerometerMaxTrust == null
+                       && CompassMinTrust == null && CompassMaxTrust == null
+                       && AxisDirections == null && DesiredUpdateRate == null
+                       && RunningAveragePercent == null && LedColor == null;
+            }
+        }
+
+        /// <summary>
+        /// Returns the settings of desired that differ from this configuration.
+        /// Trust values are written in pairs, so both halves of a pair are returned if either differs and both are known.
+        /// If the other half is neither desired nor known here, only the desired half is returned, which cannot be written.
+        /// </summary>
+        public SensorConfiguration Diff(SensorConfiguration desired)
+        {
+            var changes = new SensorConfiguration();
+            if (desired.FilterMode != null && desired.FilterMode != FilterMode) changes.FilterMode = desired.FilterMode;
+            if (desired.AccelerometerRange != null && desired.AccelerometerRange != AccelerometerRange) changes.AccelerometerRange = desired.AccelerometerRange;
+            if (desired.GyroscopeRange != null && desired.GyroscopeRange != GyroscopeRange) changes.GyroscopeRange = desired.GyroscopeRange;
+            if (desired.CompassRange != null && desired.CompassRange != CompassRange) changes.CompassRange = desired.CompassRange;
+            if (Differs(desired.AccelerometerMinTrust, AccelerometerMinTrust) || Differs(desired.AccelerometerMaxTrust, AccelerometerMaxTrust))
+            {
+                var min = desired.AccelerometerMinTrust ?? AccelerometerMinTrust;
+                var max = desired.AccelerometerMaxTrust ?? AccelerometerMaxTrust;
+                changes.AccelerometerMinTrust = min != null && max != null ? min : desired.AccelerometerMinTrust;
+                changes.AccelerometerMaxTrust = min != null && max != null ? max : desired.AccelerometerMaxTrust;
+            }
+            if (Differs(desired.CompassMinTrust, CompassMinTrust) || Differs(desired.CompassMaxTrust, CompassMaxTrust))
+            {
+                var min = desired.CompassMinTrust ?? CompassMinTrust;
+                var max = desired.CompassMaxTrust ?? CompassMaxTrust;
+                changes.CompassMinTrust = min != null && max != null ? min : desired.CompassMinTrust;
+                changes.CompassMaxTrust = min != null && max != null ? max : desired.CompassMaxTrust;
+            }
+            if (desired.AxisDirections != null && desired.AxisDirections != AxisDirections) changes.AxisDirections = desired.AxisDirections;
+            if (desired.DesiredUpdateRate != null && desired.DesiredUpdateRate != DesiredUpdateRate) changes.DesiredUpdateRate = desired.DesiredUpdateRate;
+            if (Differs(desired.RunningAveragePercent, RunningAveragePercent)) changes.RunningAveragePercent = desired.RunningAveragePercent;
+            if (desired.LedColor != null && (LedColor == null
+                                             || Differs(desired.LedColor.Value.R, LedColor.Value.R)
+                                             || Differs(desired.LedColor.Value.G, LedColor.Value.G)
+                                             || Differs(desired.LedColor.Value.B, LedColor.Value.B)))
+            {
+                changes.LedColor = desired.LedColor;
+            }
+            return changes;
+        }
+
+        /// <summary>
+        /// Overwrite the settings that are set in changes.
+        /// </summary>
+        public void Merge(SensorConfiguration changes)
+        {
+            FilterMode = changes.FilterMode ?? FilterMode;
+            AccelerometerRange = changes.AccelerometerRange ?? AccelerometerRange;
+            GyroscopeRange = changes.GyroscopeRange ?? GyroscopeRange;
+            CompassRange = changes.CompassRange ?? CompassRange;
+            AccelerometerMinTrust = changes.AccelerometerMinTrust ?? AccelerometerMinTrust;
+            AccelerometerMaxTrust = changes.AccelerometerMaxTrust ?? AccelerometerMaxTrust;
+            CompassMinTrust = changes.CompassMinTrust ?? CompassMinTrust;
+            CompassMaxTrust = changes.CompassMaxTrust ?? CompassMaxTrust;
+            AxisDirections = changes.AxisDirections ?? AxisDirections;
+            DesiredUpdateRate = changes.DesiredUpdateRate ?? DesiredUpdateRate;
+            RunningAveragePercent = changes.RunningAveragePercent ?? RunningAveragePercent;
+            LedColor = changes.LedColor ?? LedColor;
+        }
+
+        /// <summary>
+        /// Writes the set settings as "Name=Value" lines.
+        /// </summary>
+        public void Save(TextWriter writer)
+        {
+            if (FirmwareVersion != null) writer.WriteLine("FirmwareVersion={0}", FirmwareVersion);
+            if (FilterMode != null) writer.WriteLine("FilterMode={0}", (byte)FilterMode.Value);
+            if (AccelerometerRange != null) writer.WriteLine("AccelerometerRange={0}", AccelerometerRange);
+            if (GyroscopeRange != null) writer.WriteLine("GyroscopeRange={0}", GyroscopeRange);
+            if (CompassRange != null) writer.WriteLine("CompassRange={0}", CompassRange);
+            if (AccelerometerMinTrust != null) writer.WriteLine("AccelerometerMinTrust={0}", Format(AccelerometerMinTrust.Value));
+            if (AccelerometerMaxTrust != null) writer.WriteLine("AccelerometerMaxTrust={0}", Format(AccelerometerMaxTrust.Value));
+            if (CompassMinTrust != null) writer.WriteLine("CompassMinTrust={0}", Format(CompassMinTrust.Value));
+            if (CompassMaxTrust != null) writer.WriteLine("CompassMaxTrust={0}", Format(CompassMaxTrust.Value));
+            if (AxisDirections != null) writer.WriteLine("AxisDirections={0}", AxisDirections);
+            if (DesiredUpdateRate != null) writer.WriteLine("DesiredUpdateRate={0}", DesiredUpdateRate);
+            if (RunningAveragePercent != null) writer.WriteLine("RunningAveragePercent={0}", Format(RunningAveragePercent.Value));
+            if (LedColor != null)
+            {
+                writer.WriteLine("LedColor={0},{1},{2}", Format(LedColor.Value.R), Format(LedColor.Value.G), Format(LedColor.Value.B));
+            }
+        }
+
+        /// <summary>
+        /// Reads settings written by Save. Unknown or malformed lines are ignored.
+        /// </summary>
+        public static SensorConfiguration Load(TextReader reader)
+        {
+            var result = new SensorConfiguration();
+            string line;
+            while ((line = reader.ReadLine()) != null)
+            {
+                var separator = line.IndexOf('=');
+                if (separator < 0) continue;
+                var name = line.Substring(0, separator).Trim();
+                var value = line.Substring(separator + 1).Trim();
+                byte b;
+                uint u;
+                float f;
+                switch (name)
+                {
+                    case "FirmwareVersion": result.FirmwareVersion = value; break;
+                    case "FilterMode": if (byte.TryParse(value, out b)) result.FilterMode = (FilterModeEnum)b; break;
+                    case "AccelerometerRange": if (byte.TryParse(value, out b)) result.AccelerometerRange = b; break;
+                    case "GyroscopeRange": if (byte.TryParse(value, out b)) result.GyroscopeRange = b; break;
+                    case "CompassRange": if (byte.TryParse(value, out b)) result.CompassRange = b; break;
+                    case "AccelerometerMinTrust": if (TryParse(value, out f)) result.AccelerometerMinTrust = f; break;
+                    case "AccelerometerMaxTrust": if (TryParse(value, out f)) result.AccelerometerMaxTrust = f; break;
+                    case "CompassMinTrust": if (TryParse(value, out f)) result.CompassMinTrust = f; break;
+                    case "CompassMaxTrust": if (TryParse(value, out f)) result.CompassMaxTrust = f; break;
+                    case "AxisDirections": if (byte.TryParse(value, out b)) result.AxisDirections = b; break;
+                    case "DesiredUpdateRate": if (uint.TryParse(value, out u)) result.DesiredUpdateRate = u; break;
+                    case "RunningAveragePercent": if (TryParse(value, out f)) result.RunningAveragePercent = f; break;
+                    case "LedColor":
+                        var channels = value.Split(',');
+                        float r, g, bl;
+                        if (channels.Length == 3 && TryParse(channels[0], out r) && TryParse(channels[1], out g) && TryParse(channels[2], out bl))
+                        {
+                            result.LedColor = new Color { R = r, G = g, B = bl };
+                        }
+                        break;
+                }
+            }
+            return result;
+        }
+
+        private static bool Differs(float? desired, float? current)
+        {
+            return desired != null && (current == null || Differs(desired.Value, current.Value));
+        }
+
+        private static bool Differs(float desired, float current)
+        {
+            return Math.Abs(desired - current) > Tolerance;
+        }
+
+        private static string Format(float value)
+        {
+            return value.ToString("R", CultureInfo.InvariantCulture);
+        }
+
+        private static bool TryParse(string value, out float result)
+        {
+            return float.TryParse(value, NumberStyles.Float, CultureInfo.InvariantCulture, out result);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Configuration
+{
+    /// <summary>
+    /// Remembers the last known configuration of each sensor by serial number,
+    /// so a warm start can diff against it without reading the device.
+    /// Entries are kept in memory and, if a directory is given, in one file per serial number.
+    /// </summary>
+    public class SensorConfigurationCache
+    {
+        private readonly string _directory;
+        private readonly ConcurrentDictionary<uint, SensorConfiguration> _entries = new ConcurrentDictionary<uint, SensorConfiguration>();
+
+        /// <summary>
+        /// Create a cache that only lives as long as the process.
+        /// </summary>
+        public SensorConfigurationCache() { }
+
+        /// <summary>
+        /// Create a cache persisted in directory.
+        /// </summary>
+        public SensorConfigurationCache(string directory)
+        {
+            _directory = directory;
+            Directory.CreateDirectory(directory);
+        }
+
+        public bool TryGet(uint serialNumber, out SensorConfiguration configuration)
+        {
+            if (_entries.TryGetValue(serialNumber, out configuration)) return true;
+            if (_directory == null) return false;
+
+            var path = PathOf(serialNumber);
+            if (!File.Exists(path)) return false;
+            using (var reader = new StreamReader(path))
+            {
+                configuration = SensorConfiguration.Load(reader);
+            }
+            _entries[serialNumber] = configuration;
+            return true;
+        }
+
+        public void Store(uint serialNumber, SensorConfiguration configuration)
+        {
+            _entries[serialNumber] = configuration;
+            if (_directory == null) return;
+
+            var path = PathOf(serialNumber);
+            var temporary = path + ".tmp";
+            using (var writer = new StreamWriter(temporary))
+            {
+                configuration.Save(writer);
+            }
+            if (File.Exists(path)) File.Delete(path);
+            File.Move(temporary, path);
+        }
+
+        /// <summary>
+        /// Forget a sensor, the next apply reads it from the device again.
+        /// </summary>
+        public void Invalidate(uint serialNumber)
+        {
+            SensorConfiguration ignored;
+            _entries.TryRemove(serialNumber, out ignored);
+            if (_directory != null && File.Exists(PathOf(serialNumber))) File.Delete(PathOf(serialNumber));
+        }
+
+        private string PathOf(uint serialNumber)
+        {
+            return Path.Combine(_directory, serialNumber.ToString("X8") + ".cfg");
+        }
+    }
+}
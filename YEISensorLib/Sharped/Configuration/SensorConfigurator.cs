@@ -0,0 +1,172 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Configuration
+{
+    /// <summary>
+    /// Reads, diffs and applies sensor configurations, writing only the settings that differ
+    /// and committing to flash only when something was written.
+    /// </summary>
+    public static class SensorConfigurator
+    {
+        /// <summary>
+        /// Read every gettable setting of a sensor.
+        /// Settings the firmware does not support are left null.
+        /// </summary>
+        /// <returns>The snapshot, or null if the device could not be read at all.</returns>
+        public static SensorConfiguration Read(SensorDevice device)
+        {
+            if (!device.IsConnected || device.IsDongle) return null;
+
+            var id = device.DeviceId;
+            var config = new SensorConfiguration();
+            var any = false;
+            uint timeStamp;
+            byte b;
+            uint u;
+            float min, max;
+
+            ComInfo info;
+            if (ThreeSpaceInterop.GetDeviceInfo(id, out info) == ResultEnum.NoError) config.FirmwareVersion = info.FirmwareVersion;
+
+            if (ThreeSpaceInterop.GetFilterMode(id, out b, out timeStamp) == ResultEnum.NoError) { config.FilterMode = (FilterModeEnum)b; any = true; }
+            if (ThreeSpaceInterop.GetAccelerometerRange(id, out b, out timeStamp) == ResultEnum.NoError) { config.AccelerometerRange = b; any = true; }
+            if (ThreeSpaceInterop.GetGyroscopeRange(id, out b, out timeStamp) == ResultEnum.NoError) { config.GyroscopeRange = b; any = true; }
+            if (ThreeSpaceInterop.GetCompassRange(id, out b, out timeStamp) == ResultEnum.NoError) { config.CompassRange = b; any = true; }
+            if (ThreeSpaceInterop.GetAccelerometerTrustValues(id, out min, out max, out timeStamp) == ResultEnum.NoError)
+            {
+                config.AccelerometerMinTrust = min;
+                config.AccelerometerMaxTrust = max;
+                any = true;
+            }
+            if (ThreeSpaceInterop.GetCompassTrustValues(id, out min, out max, out timeStamp) == ResultEnum.NoError)
+            {
+                config.CompassMinTrust = min;
+                config.CompassMaxTrust = max;
+                any = true;
+            }
+            if (ThreeSpaceInterop.GetAxisDirections(id, out b, out timeStamp) == ResultEnum.NoError) { config.AxisDirections = b; any = true; }
+            if (ThreeSpaceInterop.GetDesiredUpdateRate(id, out u, out timeStamp) == ResultEnum.NoError) { config.DesiredUpdateRate = u; any = true; }
+            if (ThreeSpaceInterop.GetRunningAveragePercent(id, out min, out timeStamp) == ResultEnum.NoError) { config.RunningAveragePercent = min; any = true; }
+
+            Color color;
+            if (ThreeSpaceInterop.GetLedColor(id, out color, out timeStamp) == ResultEnum.NoError) { config.LedColor = color; any = true; }
+
+            return any ? config : null;
+        }
+
+        /// <summary>
+        /// Bring a sensor to the desired profile.
+        /// The current settings come from the cache when the sensor's serial number (and firmware) is known,
+        /// otherwise from the device. Only differing settings are written, and settings are committed only if
+        /// something was written and every write succeeded, so a half applied profile is never saved to flash
+        /// (it is lost at the next power cycle).
+        /// </summary>
+        /// <param name="device">The sensor to configure.</param>
+        /// <param name="desired">The settings wanted, null settings are left alone.</param>
+        /// <param name="cache">Known configurations by serial number, may be null.</param>
+        public static ConfigurationApplyResult Apply(SensorDevice device, SensorConfiguration desired, SensorConfigurationCache cache)
+        {
+            var result = new ConfigurationApplyResult();
+            if (!device.IsConnected || device.IsDongle) return result;
+
+            ComInfo info;
+            var hasInfo = ThreeSpaceInterop.GetDeviceInfo(device.DeviceId, out info) == ResultEnum.NoError;
+            result.SerialNumber = hasInfo ? info.SerialNumber : device.SerialNumberValue;
+
+            SensorConfiguration current = null;
+            if (cache != null && cache.TryGet(result.SerialNumber, out current)
+                && hasInfo && current.FirmwareVersion != null && current.FirmwareVersion != info.FirmwareVersion)
+            {
+                current = null;
+            }
+            result.UsedCache = current != null;
+            if (current == null) current = Read(device);
+            if (current == null) return result;
+
+            var changes = current.Diff(desired);
+            result.Changes = changes;
+            result.Success = Write(device.DeviceId, changes, result);
+
+            if (result.Success && result.SettingsWritten > 0)
+            {
+                uint timeStamp;
+                result.Committed = ThreeSpaceInterop.CommitSettings(device.DeviceId, out timeStamp) == ResultEnum.NoError;
+                result.Success &= result.Committed;
+            }
+
+            if (cache != null)
+            {
+                if (result.Success)
+                {
+                    current.Merge(changes);
+                    cache.Store(result.SerialNumber, current);
+                }
+                else
+                {
+                    //What the device holds now is unknown, read it next time.
+                    cache.Invalidate(result.SerialNumber);
+                }
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Apply a profile to many sensors at once.
+        /// The API serializes calls per device, so the sensors are configured concurrently to overlap their round trips.
+        /// </summary>
+        public static List<ConfigurationApplyResult> ApplyAll(IList<SensorDevice> devices, SensorConfiguration desired, SensorConfigurationCache cache)
+        {
+            var results = new ConfigurationApplyResult[devices.Count];
+            Parallel.For(0, devices.Count, i => results[i] = Apply(devices[i], desired, cache));
+            return results.ToList();
+        }
+
+        private static bool Write(uint id, SensorConfiguration changes, ConfigurationApplyResult result)
+        {
+            var success = true;
+            uint timeStamp;
+            if (changes.FilterMode != null) success &= Count(ThreeSpaceInterop.SetFilterMode(id, (byte)changes.FilterMode.Value, out timeStamp), result);
+            if (changes.AccelerometerRange != null) success &= Count(ThreeSpaceInterop.SetAccelerometerRange(id, changes.AccelerometerRange.Value, out timeStamp), result);
+            if (changes.GyroscopeRange != null) success &= Count(ThreeSpaceInterop.SetGyroscopeRange(id, changes.GyroscopeRange.Value, out timeStamp), result);
+            if (changes.CompassRange != null) success &= Count(ThreeSpaceInterop.SetCompassRange(id, changes.CompassRange.Value, out timeStamp), result);
+            if (changes.AccelerometerMinTrust != null && changes.AccelerometerMaxTrust != null)
+            {
+                success &= Count(ThreeSpaceInterop.SetAccelerometerTrustValues(id, changes.AccelerometerMinTrust.Value, changes.AccelerometerMaxTrust.Value, out timeStamp), result);
+            }
+            else if (changes.AccelerometerMinTrust != null || changes.AccelerometerMaxTrust != null)
+            {
+                //Half a pair cannot be written.
+                success = false;
+            }
+            if (changes.CompassMinTrust != null && changes.CompassMaxTrust != null)
+            {
+                success &= Count(ThreeSpaceInterop.SetCompassTrustValues(id, changes.CompassMinTrust.Value, changes.CompassMaxTrust.Value, out timeStamp), result);
+            }
+            else if (changes.CompassMinTrust != null || changes.CompassMaxTrust != null)
+            {
+                success = false;
+            }
+            if (changes.AxisDirections != null) success &= Count(ThreeSpaceInterop.SetAxisDirections(id, changes.AxisDirections.Value, out timeStamp), result);
+            if (changes.DesiredUpdateRate != null) success &= Count(ThreeSpaceInterop.SetDesiredUpdateRate(id, changes.DesiredUpdateRate.Value, out timeStamp), result);
+            if (changes.RunningAveragePercent != null) success &= Count(ThreeSpaceInterop.SetRunningAveragePercent(id, changes.RunningAveragePercent.Value, out timeStamp), result);
+            if (changes.LedColor != null)
+            {
+                var color = changes.LedColor.Value;
+                success &= Count(ThreeSpaceInterop.SetLedColor(id, new[] { color.R, color.G, color.B }, 0), result);
+            }
+            return success;
+        }
+
+        private static bool Count(ResultEnum resultCode, ConfigurationApplyResult result)
+        {
+            if (resultCode != ResultEnum.NoError) return false;
+            result.SettingsWritten++;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.DataLogging
+{
+    /// <summary>
+    /// Describes the text files a data-logging sensor writes to its SD card.
+    /// Each line holds the output of the logged commands in slot order, separated by commas.
+    /// </summary>
+    public class DataLogFormat
+    {
+        /// <summary>
+        /// The commands logged on each line, in order.
+        /// </summary>
+        public StreamSlotLayout Layout { get; set; }
+
+        /// <summary>
+        /// True if each line starts with the sensor timestamp (microseconds).
+        /// </summary>
+        public bool HasTimeStampColumn { get; set; }
+
+        /// <summary>
+        /// Interval between lines in microseconds, used to synthesize timestamps when there is no timestamp column.
+        /// </summary>
+        public uint SampleIntervalMicroseconds { get; set; }
+
+        /// <summary>
+        /// Search pattern of the session files on the card.
+        /// </summary>
+        public string FilePattern { get; set; }
+
+        public DataLogFormat(StreamSlotLayout layout)
+        {
+            Layout = layout;
+            HasTimeStampColumn = false;
+            SampleIntervalMicroseconds = 10000;
+            FilePattern = "*.TXT";
+        }
+    }
+}
@@ -0,0 +1,330 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Recording;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.DataLogging
+{
+    /// <summary>
+    /// Converts data-log text files into session logs.
+    /// 
+    /// The file is read in chunks cut on line boundaries. A batch of chunks is parsed in parallel
+    /// (one chunk per core) while the next batch is read, then written out in order.
+    /// Memory use does not grow with the file size: 2 * Parallelism chunks are in flight, each holding ChunkSize
+    /// bytes of text plus the records parsed from it, RecordSize per line (more than the text for short lines).
+    /// </summary>
+    public class DataLogIngest
+    {
+        private const int MaxLineLength = 64 * 1024;
+
+        private static readonly double[] PowersOfTen = Enumerable.Range(0, 39).Select(i => Math.Pow(10, i)).ToArray();
+
+        public DataLogFormat Format { get; private set; }
+
+        /// <summary>
+        /// Bytes of text per chunk.
+        /// </summary>
+        public int ChunkSize { get; set; }
+
+        /// <summary>
+        /// Chunks parsed at once, defaults to the number of cores.
+        /// </summary>
+        public int Parallelism { get; set; }
+
+        public DataLogIngest(DataLogFormat format)
+        {
+            Format = format;
+            ChunkSize = 4 * 1024 * 1024;
+            Parallelism = Environment.ProcessorCount;
+        }
+
+        /// <summary>
+        /// Convert a data-log file into a new session log.
+        /// </summary>
+        public DataLogIngestResult Ingest(string sourcePath, string destinationPath, uint serialNumber)
+        {
+            using (var destination = new SessionLogWriter(destinationPath, new SessionLogHeader(serialNumber, Format.Layout)))
+            {
+                var result = Ingest(sourcePath, destination);
+                result.DestinationPath = destinationPath;
+                return result;
+            }
+        }
+
+        /// <summary>
+        /// Convert a data-log file, appending its records to destination.
+        /// </summary>
+        public DataLogIngestResult Ingest(string sourcePath, SessionLogWriter destination)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            var result = new DataLogIngestResult { SourcePath = sourcePath };
+            var recordSize = 4 + Format.Layout.PayloadSize;
+
+            using (var source = new FileStream(sourcePath, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 16, FileOptions.SequentialScan))
+            {
+                var reader = new ChunkReader(source, ChunkSize);
+                var current = CreateBatch();
+                var next = CreateBatch();
+                reader.Fill(current);
+
+                while (current.Count > 0)
+                {
+                    var batch = current;
+                    var readAhead = Task.Factory.StartNew(() => reader.Fill(next));
+
+                    Parallel.For(0, batch.Count, new ParallelOptions { MaxDegreeOfParallelism = Parallelism },
+                                 i => batch.Chunks[i].Parse(Format, recordSize));
+
+                    for (var i = 0; i < batch.Count; i++)
+                    {
+                        var chunk = batch.Chunks[i];
+                        if (!Format.HasTimeStampColumn)
+                        {
+                            for (var r = 0; r < chunk.Records; r++)
+                            {
+                                var timeStamp = (uint)((destination.RecordCount + r) * Format.SampleIntervalMicroseconds);
+                                FloatBits.WriteInt32(chunk.Output, r * recordSize, (int)timeStamp);
+                            }
+                        }
+                        destination.WriteRecords(chunk.Output, 0, chunk.Records);
+                        result.BytesRead += chunk.Length;
+                        result.Records += chunk.Records;
+                        result.SkippedLines += chunk.SkippedLines;
+                    }
+
+                    readAhead.Wait();
+                    current = next;
+                    next = batch;
+                }
+            }
+
+            destination.Flush();
+            result.Elapsed = stopwatch.Elapsed;
+            return result;
+        }
+
+        private ChunkBatch CreateBatch()
+        {
+            var batch = new ChunkBatch { Chunks = new Chunk[Math.Max(1, Parallelism)] };
+            for (var i = 0; i < batch.Chunks.Length; i++) batch.Chunks[i] = new Chunk { Text = new byte[ChunkSize + MaxLineLength] };
+            return batch;
+        }
+
+        private class ChunkBatch
+        {
+            public Chunk[] Chunks;
+            public int Count;
+        }
+
+        /// <summary>
+        /// Reads the source into chunks that end on a line boundary, carrying partial lines over.
+        /// </summary>
+        private class ChunkReader
+        {
+            private readonly Stream _source;
+            private readonly int _chunkSize;
+            private readonly byte[] _carry = new byte[MaxLineLength];
+            private int _carryLength;
+            private bool _endOfFile;
+
+            public ChunkReader(Stream source, int chunkSize)
+            {
+                _source = source;
+                _chunkSize = chunkSize;
+            }
+
+            public void Fill(ChunkBatch batch)
+            {
+                batch.Count = 0;
+                while (batch.Count < batch.Chunks.Length && !(_endOfFile && _carryLength == 0))
+                {
+                    var chunk = batch.Chunks[batch.Count];
+                    Buffer.BlockCopy(_carry, 0, chunk.Text, 0, _carryLength);
+                    var length = _carryLength;
+                    _carryLength = 0;
+
+                    while (!_endOfFile && length < _chunkSize)
+                    {
+                        var read = _source.Read(chunk.Text, length, _chunkSize - length);
+                        if (read == 0) _endOfFile = true;
+                        length += read;
+                    }
+
+                    var lastNewLine = _endOfFile ? length - 1 : Array.LastIndexOf(chunk.Text, (byte)'\n', length - 1, length);
+                    if (lastNewLine >= 0 && length - lastNewLine - 1 <= MaxLineLength)
+                    {
+                        _carryLength = length - lastNewLine - 1;
+                        Buffer.BlockCopy(chunk.Text, lastNewLine + 1, _carry, 0, _carryLength);
+                        length = lastNewLine + 1;
+                    }
+                    //Otherwise the chunk holds one giant line, it is parsed (and skipped) as is.
+
+                    chunk.Length = length;
+                    if (length > 0) batch.Count++;
+                }
+            }
+        }
+
+        /// <summary>
+        /// A block of whole lines and the records parsed from it.
+        /// </summary>
+        private class Chunk
+        {
+            public byte[] Text;
+            public int Length;
+            public byte[] Output = new byte[0];
+            public int Records;
+            public int SkippedLines;
+
+            public void Parse(DataLogFormat format, int recordSize)
+            {
+                Records = 0;
+                SkippedLines = 0;
+                var lineStart = 0;
+                while (lineStart < Length)
+                {
+                    var lineEnd = Array.IndexOf(Text, (byte)'\n', lineStart, Length - lineStart);
+                    if (lineEnd < 0) lineEnd = Length;
+                    var contentEnd = lineEnd;
+                    if (contentEnd > lineStart && Text[contentEnd - 1] == (byte)'\r') contentEnd--;
+
+                    if (contentEnd > lineStart)
+                    {
+                        if (Output.Length < (Records + 1) * recordSize)
+                        {
+                            Array.Resize(ref Output, Math.Max(recordSize * 1024, Output.Length * 2));
+                        }
+                        if (ParseLine(Text, lineStart, contentEnd, format, Output, Records * recordSize)) Records++;
+                        else SkippedLines++;
+                    }
+                    lineStart = lineEnd + 1;
+                }
+            }
+        }
+
+        private static bool ParseLine(byte[] text, int position, int end, DataLogFormat format, byte[] output, int outputOffset)
+        {
+            double value;
+            var timeStamp = 0u;
+            if (format.HasTimeStampColumn)
+            {
+                if (!TryParseField(text, ref position, end, out value) || value < 0 || value > uint.MaxValue) return false;
+                timeStamp = (uint)value;
+            }
+            FloatBits.WriteInt32(output, outputOffset, (int)timeStamp);
+
+            var offset = outputOffset + 4;
+            foreach (var command in format.Layout.Slots)
+            {
+                var count = StreamSlotLayout.ValueCount(command);
+                var isByte = StreamSlotLayout.IsByteValued(command);
+                for (var i = 0; i < count; i++)
+                {
+                    if (!TryParseField(text, ref position, end, out value)) return false;
+                    if (isByte)
+                    {
+                        output[offset++] = (byte)value;
+                    }
+                    else
+                    {
+                        FloatBits.WriteInt32(output, offset, FloatBits.ToInt32((float)value));
+                        offset += 4;
+                    }
+                }
+            }
+
+            SkipSpaces(text, ref position, end);
+            return position == end;
+        }
+
+        /// <summary>
+        /// Parses one decimal field and its trailing separator.
+        /// Hand rolled because float.Parse allocates a string per value and dominates ingest time.
+        /// </summary>
+        private static bool TryParseField(byte[] text, ref int position, int end, out double value)
+        {
+            value = 0;
+            SkipSpaces(text, ref position, end);
+
+            var negative = false;
+            if (position < end && (text[position] == (byte)'-' || text[position] == (byte)'+'))
+            {
+                negative = text[position] == (byte)'-';
+                position++;
+            }
+
+            long mantissa = 0;
+            var digits = 0;
+            var scale = 0;
+            var any = false;
+            while (position < end && IsDigit(text[position]))
+            {
+                if (digits < 18) { mantissa = mantissa * 10 + (text[position] - '0'); if (mantissa > 0) digits++; }
+                else scale++;
+                any = true;
+                position++;
+            }
+            if (position < end && text[position] == (byte)'.')
+            {
+                position++;
+                while (position < end && IsDigit(text[position]))
+                {
+                    if (digits < 18) { mantissa = mantissa * 10 + (text[position] - '0'); if (mantissa > 0) digits++; scale--; }
+                    any = true;
+                    position++;
+                }
+            }
+            if (!any) return false;
+
+            if (position < end && (text[position] == (byte)'e' || text[position] == (byte)'E'))
+            {
+                position++;
+                var exponentNegative = false;
+                if (position < end && (text[position] == (byte)'-' || text[position] == (byte)'+'))
+                {
+                    exponentNegative = text[position] == (byte)'-';
+                    position++;
+                }
+                var exponent = 0;
+                var anyExponent = false;
+                while (position < end && IsDigit(text[position]))
+                {
+                    if (exponent < 1000) exponent = exponent * 10 + (text[position] - '0');
+                    anyExponent = true;
+                    position++;
+                }
+                if (!anyExponent) return false;
+                scale += exponentNegative ? -exponent : exponent;
+            }
+
+            value = mantissa;
+            if (scale < 0) value /= -scale < PowersOfTen.Length ? PowersOfTen[-scale] : Math.Pow(10, -scale);
+            else if (scale > 0) value *= scale < PowersOfTen.Length ? PowersOfTen[scale] : Math.Pow(10, scale);
+            if (negative) value = -value;
+
+            SkipSpaces(text, ref position, end);
+            if (position < end)
+            {
+                if (text[position] != (byte)',') return false;
+                position++;
+            }
+            return true;
+        }
+
+        private static bool IsDigit(byte c)
+        {
+            return c >= (byte)'0' && c <= (byte)'9';
+        }
+
+        private static void SkipSpaces(byte[] text, ref int position, int end)
+        {
+            while (position < end && (text[position] == (byte)' ' || text[position] == (byte)'\t')) position++;
+        }
+    }
+}
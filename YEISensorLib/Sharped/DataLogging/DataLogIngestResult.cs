@@ -0,0 +1,34 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.DataLogging
+{
+    /// <summary>
+    /// Outcome of converting one data-log file into a session log.
+    /// </summary>
+    public class DataLogIngestResult
+    {
+        public string SourcePath { get; set; }
+        public string DestinationPath { get; set; }
+        public long BytesRead { get; set; }
+        public long Records { get; set; }
+
+        /// <summary>
+        /// Lines that could not be parsed (headers, truncated last line, corrupt data).
+        /// </summary>
+        public long SkippedLines { get; set; }
+
+        public TimeSpan Elapsed { get; set; }
+
+        /// <summary>
+        /// Conversion speed in megabytes of source text per second.
+        /// </summary>
+        public double MegabytesPerSecond
+        {
+            get { return Elapsed.TotalSeconds > 0 ? BytesRead / (1024.0 * 1024.0) / Elapsed.TotalSeconds : 0; }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.DataLogging
+{
+    /// <summary>
+    /// Pulls the logged sessions off a data-logging sensor.
+    /// Ends the logging session, exposes the SD card as a drive, converts every session file
+    /// and hands the card back to the sensor, even if a conversion fails.
+    /// </summary>
+    public class DataLoggerOffload
+    {
+        private static readonly TimeSpan PollInterval = TimeSpan.FromMilliseconds(250);
+
+        /// <summary>
+        /// How long to wait for the SD card to show up as a drive.
+        /// </summary>
+        public TimeSpan MountTimeout { get; set; }
+
+        public DataLogIngest Ingest { get; private set; }
+
+        public DataLoggerOffload(DataLogFormat format)
+        {
+            MountTimeout = TimeSpan.FromSeconds(30);
+            Ingest = new DataLogIngest(format);
+        }
+
+        /// <summary>
+        /// Convert every session file on the sensor's card into destinationDirectory.
+        /// Output files are named after the sensor serial and the source file.
+        /// </summary>
+        /// <returns>One result per converted file, empty if the card could not be mounted.</returns>
+        public List<DataLogIngestResult> OffloadSessions(SensorDevice device, string destinationDirectory)
+        {
+            var results = new List<DataLogIngestResult>();
+            var root = Mount(device);
+            if (root == null) return results;
+
+            try
+            {
+                Directory.CreateDirectory(destinationDirectory);
+                var files = Directory.GetFiles(root, Ingest.Format.FilePattern, SearchOption.AllDirectories);
+                Array.Sort(files, StringComparer.OrdinalIgnoreCase);
+                foreach (var file in files)
+                {
+                    var destination = Path.Combine(destinationDirectory,
+                                                   string.Format("{0}_{1}.ysl", device.SerialNumber, Path.GetFileNameWithoutExtension(file)));
+                    results.Add(Ingest.Ingest(file, destination, device.SerialNumberValue));
+                }
+            }
+            finally
+            {
+                device.TurnOffMassStorage();
+            }
+            return results;
+        }
+
+        /// <summary>
+        /// End logging and expose the card, returning the root of the new drive or null if none appeared.
+        /// </summary>
+        public string Mount(SensorDevice device)
+        {
+            var before = new HashSet<string>(RemovableDrives(), StringComparer.OrdinalIgnoreCase);
+
+            device.EndDataLoggingSession();
+            if (!device.TurnOnMassStorage()) return null;
+
+            var deadline = DateTime.UtcNow + MountTimeout;
+            while (DateTime.UtcNow < deadline)
+            {
+                var mounted = RemovableDrives().FirstOrDefault(d => !before.Contains(d));
+                if (mounted != null) return mounted;
+                Thread.Sleep(PollInterval);
+            }
+
+            device.TurnOffMassStorage();
+            return null;
+        }
+
+        private static IEnumerable<string> RemovableDrives()
+        {
+            return DriveInfo.GetDrives()
+                .Where(d => d.DriveType == DriveType.Removable && d.IsReady)
+                .Select(d => d.RootDirectory.FullName)
+                .ToList();
+        }
+    }
+}
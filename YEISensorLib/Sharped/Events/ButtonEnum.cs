@@ -0,0 +1,17 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Events
+{
+    /// <summary>
+    /// Physical buttons of a sensor, the value is the bit in the button state bitfield.
+    /// </summary>
+    public enum ButtonEnum
+    {
+        Left = 0,
+        Right = 1,
+    }
+}
@@ -0,0 +1,40 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Events
+{
+    /// <summary>
+    /// A button went down or up between two stream packets.
+    /// </summary>
+    public class ButtonEventArgs : EventArgs
+    {
+        public SensorStream Stream { get; private set; }
+
+        public ButtonEnum Button { get; private set; }
+
+        public bool Pressed { get; private set; }
+
+        /// <summary>
+        /// Sensor timestamp of the first packet showing the new state.
+        /// </summary>
+        public uint TimeStamp { get; private set; }
+
+        /// <summary>
+        /// How long the button was held, in microseconds. Zero for a press.
+        /// </summary>
+        public uint HeldMicroseconds { get; private set; }
+
+        public ButtonEventArgs(SensorStream stream, ButtonEnum button, bool pressed, uint timeStamp, uint heldMicroseconds)
+        {
+            Stream = stream;
+            Button = button;
+            Pressed = pressed;
+            TimeStamp = timeStamp;
+            HeldMicroseconds = heldMicroseconds;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Analytics;
+
+namespace YEISensorLib.Sharped.Events
+{
+    /// <summary>
+    /// Fires when a quantity rises to Threshold, then re-arms once it falls below Threshold - Hysteresis
+    /// and at least HoldOffMicroseconds have passed, so one spike gives one event.
+    /// The sensor must stream a slot feeding the quantity (e.g. CorrectedAccelerometerVector for AccelerometerMagnitude).
+    /// </summary>
+    public class MotionTrigger
+    {
+        public string Name { get; private set; }
+
+        public WindowQuantityEnum Quantity { get; private set; }
+
+        public float Threshold { get; private set; }
+
+        public float Hysteresis { get; set; }
+
+        /// <summary>
+        /// Minimum time between two events of this trigger on a stream.
+        /// </summary>
+        public uint HoldOffMicroseconds { get; set; }
+
+        /// <param name="name">Name passed back with the events.</param>
+        /// <param name="quantity">Scalar taken from each sample.</param>
+        /// <param name="threshold">Value the quantity has to reach.</param>
+        public MotionTrigger(string name, WindowQuantityEnum quantity, float threshold)
+        {
+            Name = name;
+            Quantity = quantity;
+            Threshold = threshold;
+            Hysteresis = Math.Abs(threshold) * 0.1f;
+        }
+    }
+}
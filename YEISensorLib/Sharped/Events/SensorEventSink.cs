@@ -0,0 +1,133 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Analytics;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Events
+{
+    /// <summary>
+    /// Turns streamed samples into button press/release and motion trigger events, without any device I/O.
+    /// 
+    /// Buttons are read from the ButtonState slot of each packet, so every press longer than the stream
+    /// interval is seen, where polling tss_getButtonState misses presses shorter than the loop.
+    /// Packets without the slot (e.g. while a SlotMultiplexer has rotated it out) keep the last state.
+    /// Events carry the sensor timestamp of the sample that caused them and are raised on the stream's
+    /// callback thread: keep handlers short, or hand the work off.
+    /// 
+    /// Usage:
+    ///     var events = new SensorEventSink(new MotionTrigger("Impact", WindowQuantityEnum.AccelerometerMagnitude, 3));
+    ///     events.ButtonPressed += (s, e) => Console.WriteLine(e.Button + " at " + e.TimeStamp);
+    ///     events.Triggered += (s, e) => Console.WriteLine(e.Trigger.Name + " " + e.Value);
+    ///     stream.AddSink(events);
+    /// </summary>
+    public class SensorEventSink : IStreamSink
+    {
+        private static readonly ButtonEnum[] Buttons = { ButtonEnum.Left, ButtonEnum.Right };
+
+        private readonly MotionTrigger[] _triggers;
+        private readonly ConcurrentDictionary<SensorStream, StreamState> _states = new ConcurrentDictionary<SensorStream, StreamState>();
+
+        public event EventHandler<ButtonEventArgs> ButtonPressed;
+
+        public event EventHandler<ButtonEventArgs> ButtonReleased;
+
+        public event EventHandler<TriggerEventArgs> Triggered;
+
+        public IList<MotionTrigger> Triggers { get { return _triggers; } }
+
+        public SensorEventSink(params MotionTrigger[] triggers)
+        {
+            _triggers = triggers;
+        }
+
+        /// <summary>
+        /// True if the button was down in the last packet of the stream that had the ButtonState slot.
+        /// </summary>
+        public bool IsPressed(SensorStream stream, ButtonEnum button)
+        {
+            StreamState state;
+            return _states.TryGetValue(stream, out state) && (state.Buttons & (1 << (int)button)) != 0;
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            var state = _states.GetOrAdd(stream, s => new StreamState(_triggers.Length));
+            var timeStamp = sample.TimeStamp;
+
+            var offset = stream.PacketLayout.OffsetOf(StreamCommandEnum.ButtonState);
+            if (offset >= 0) DetectButtons(stream, state, payload[offset], timeStamp);
+
+            for (var t = 0; t < _triggers.Length; t++)
+            {
+                var trigger = _triggers[t];
+                var value = WindowAggregationSink.Extract(trigger.Quantity, ref sample);
+                if (state.Armed[t])
+                {
+                    if (value < trigger.Threshold) continue;
+
+                    state.Armed[t] = false;
+                    state.LastFired[t] = timeStamp;
+                    var handler = Triggered;
+                    if (handler != null) handler(this, new TriggerEventArgs(stream, trigger, timeStamp, value));
+                }
+                else if (value < trigger.Threshold - trigger.Hysteresis
+                         && unchecked(timeStamp - state.LastFired[t]) >= trigger.HoldOffMicroseconds)
+                {
+                    state.Armed[t] = true;
+                }
+            }
+        }
+
+        private void DetectButtons(SensorStream stream, StreamState state, byte buttons, uint timeStamp)
+        {
+            var changed = buttons ^ state.Buttons;
+            if (!state.HasButtons)
+            {
+                //The first packet only sets the state, a button already held is not a press.
+                changed = 0;
+                state.HasButtons = true;
+            }
+            state.Buttons = buttons;
+            if (changed == 0) return;
+
+            foreach (var button in Buttons)
+            {
+                var bit = 1 << (int)button;
+                if ((changed & bit) == 0) continue;
+
+                if ((buttons & bit) != 0)
+                {
+                    state.PressedAt[(int)button] = timeStamp;
+                    var handler = ButtonPressed;
+                    if (handler != null) handler(this, new ButtonEventArgs(stream, button, true, timeStamp, 0));
+                }
+                else
+                {
+                    var held = unchecked(timeStamp - state.PressedAt[(int)button]);
+                    var handler = ButtonReleased;
+                    if (handler != null) handler(this, new ButtonEventArgs(stream, button, false, timeStamp, held));
+                }
+            }
+        }
+
+        private class StreamState
+        {
+            public bool HasButtons;
+            public byte Buttons;
+            public readonly uint[] PressedAt = new uint[2];
+            public readonly bool[] Armed;
+            public readonly uint[] LastFired;
+
+            public StreamState(int triggers)
+            {
+                Armed = Enumerable.Repeat(true, triggers).ToArray();
+                LastFired = new uint[triggers];
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Events
+{
+    /// <summary>
+    /// A motion trigger's quantity crossed its threshold.
+    /// </summary>
+    public class TriggerEventArgs : EventArgs
+    {
+        public SensorStream Stream { get; private set; }
+
+        public MotionTrigger Trigger { get; private set; }
+
+        /// <summary>
+        /// Sensor timestamp of the sample that crossed the threshold.
+        /// </summary>
+        public uint TimeStamp { get; private set; }
+
+        /// <summary>
+        /// The quantity in that sample.
+        /// </summary>
+        public float Value { get; private set; }
+
+        public TriggerEventArgs(SensorStream stream, MotionTrigger trigger, uint timeStamp, float value)
+        {
+            Stream = stream;
+            Trigger = trigger;
+            TimeStamp = timeStamp;
+            Value = value;
+        }
+    }
+}
@@ -0,0 +1,28 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.History
+{
+    /// <summary>
+    /// A float of SensorSample kept as a column of a SensorHistory.
+    /// </summary>
+    public enum HistoryFieldEnum
+    {
+        QuaternionX,
+        QuaternionY,
+        QuaternionZ,
+        QuaternionW,
+        GyroX,
+        GyroY,
+        GyroZ,
+        AccelerometerX,
+        AccelerometerY,
+        AccelerometerZ,
+        CompassX,
+        CompassY,
+        CompassZ,
+    }
+}
@@ -0,0 +1,78 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.History
+{
+    /// <summary>
+    /// Shared recent history of every stream it is added to, so consumers stop keeping their own copies.
+    /// Each stream gets a SensorHistory of the same fields and a fixed size, taken from a memory budget per sensor.
+    /// 
+    /// Usage:
+    ///     var history = new HistoryStore(64 * 1024, HistoryFieldEnum.GyroX, HistoryFieldEnum.GyroY, HistoryFieldEnum.GyroZ);
+    ///     stream.AddSink(history);
+    ///     ...
+    ///     var window = history.History(stream).Last(500);
+    ///     var gyroX = window.Older(HistoryFieldEnum.GyroX);    //Then window.Newer, then check window.IsIntact.
+    /// </summary>
+    public class HistoryStore : IStreamSink
+    {
+        private readonly ConcurrentDictionary<SensorStream, SensorHistory> _histories = new ConcurrentDictionary<SensorStream, SensorHistory>();
+        private readonly HistoryFieldEnum[] _fields;
+        private readonly Func<SensorStream, SensorHistory> _create;
+
+        public IList<HistoryFieldEnum> Fields { get { return _fields; } }
+
+        /// <summary>
+        /// Samples kept per stream.
+        /// </summary>
+        public int Capacity { get; private set; }
+
+        /// <summary>
+        /// Bytes used per stream.
+        /// </summary>
+        public int BytesPerSensor { get { return Capacity * (_fields.Length + 1) * 4; } }
+
+        /// <param name="bytesPerSensor">Memory budget per stream, the capacity is the largest multiple of SensorHistory.Alignment that fits.</param>
+        /// <param name="fields">The fields kept.</param>
+        public HistoryStore(int bytesPerSensor, params HistoryFieldEnum[] fields)
+        {
+            _fields = fields.Distinct().ToArray();
+            Capacity = bytesPerSensor / ((_fields.Length + 1) * 4) / SensorHistory.Alignment * SensorHistory.Alignment;
+            if (Capacity < SensorHistory.Alignment) throw new ArgumentOutOfRangeException("bytesPerSensor", "The budget does not hold " + SensorHistory.Alignment + " samples.");
+            _create = s => new SensorHistory(s, Capacity, _fields);
+        }
+
+        /// <summary>
+        /// The stream's history, or null before its first sample.
+        /// </summary>
+        public SensorHistory History(SensorStream stream)
+        {
+            SensorHistory history;
+            return _histories.TryGetValue(stream, out history) ? history : null;
+        }
+
+        public IDictionary<SensorStream, SensorHistory> Histories
+        {
+            get { return _histories.ToDictionary(p => p.Key, p => p.Value); }
+        }
+
+        /// <summary>
+        /// Drop a stream's history, e.g. once the stream is disposed.
+        /// </summary>
+        public void Remove(SensorStream stream)
+        {
+            SensorHistory history;
+            _histories.TryRemove(stream, out history);
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            _histories.GetOrAdd(stream, _create).Append(ref sample);
+        }
+    }
+}
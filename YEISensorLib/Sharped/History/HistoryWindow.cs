@@ -0,0 +1,92 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.History
+{
+    /// <summary>
+    /// A run of consecutive samples of a SensorHistory, viewed in place.
+    /// 
+    /// The ring may wrap inside the window, so every column comes as two segments: Older, then Newer, which is
+    /// empty unless the window wraps. The segments point into the live buffers, nothing is copied.
+    /// The writer keeps going while they are read: check IsIntact after scanning, false means the oldest samples
+    /// were overwritten meanwhile and the scan should be discarded or redone.
+    /// </summary>
+    public struct HistoryWindow
+    {
+        private readonly SensorHistory _history;
+        private readonly long _start;
+        private readonly int _length;
+
+        public SensorHistory History { get { return _history; } }
+
+        /// <summary>
+        /// Index of the first sample, counted from the first sample ever written.
+        /// </summary>
+        public long Start { get { return _start; } }
+
+        public int Length { get { return _length; } }
+
+        /// <summary>
+        /// True if no sample of the window has been overwritten yet.
+        /// </summary>
+        public bool IsIntact
+        {
+            get
+            {
+                if (_length == 0) return true;
+                //A full fence: the reads of the scan must not move after the read of Written.
+                Thread.MemoryBarrier();
+                return _history.Oldest <= _start;
+            }
+        }
+
+        internal HistoryWindow(SensorHistory history, long start, int length)
+        {
+            _history = history;
+            _start = start;
+            _length = length;
+        }
+
+        public ArraySegment<float> Older(HistoryFieldEnum field)
+        {
+            return new ArraySegment<float>(_history.Data, _history.ColumnOffset(field) + OlderOffset, OlderLength);
+        }
+
+        public ArraySegment<float> Newer(HistoryFieldEnum field)
+        {
+            return new ArraySegment<float>(_history.Data, _history.ColumnOffset(field), _length - OlderLength);
+        }
+
+        public ArraySegment<uint> OlderTimeStamps()
+        {
+            return new ArraySegment<uint>(_history.TimeStamps, OlderOffset, OlderLength);
+        }
+
+        public ArraySegment<uint> NewerTimeStamps()
+        {
+            return new ArraySegment<uint>(_history.TimeStamps, 0, _length - OlderLength);
+        }
+
+        /// <summary>
+        /// Copy a column, oldest first.
+        /// </summary>
+        /// <returns>False if the window was overwritten during the copy.</returns>
+        public bool CopyTo(HistoryFieldEnum field, float[] buffer, int offset)
+        {
+            var older = Older(field);
+            var newer = Newer(field);
+            Array.Copy(older.Array, older.Offset, buffer, offset, older.Count);
+            Array.Copy(newer.Array, newer.Offset, buffer, offset + older.Count, newer.Count);
+            Thread.MemoryBarrier();
+            return IsIntact;
+        }
+
+        private int OlderOffset { get { return _length == 0 ? 0 : (int)(_start % _history.Capacity); } }
+
+        private int OlderLength { get { return Math.Min(_length, _history.Capacity - OlderOffset); } }
+    }
+}
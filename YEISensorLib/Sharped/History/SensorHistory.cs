@@ -0,0 +1,166 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.History
+{
+    /// <summary>
+    /// The recent samples of one stream, as a ring of columns: one run of floats per field, all in a single array,
+    /// plus one of timestamps. Windowed analytics scan a field's floats contiguously instead of striding over samples.
+    /// 
+    /// Capacity is a multiple of 16 so every column starts 64 bytes after the previous one, on a cache line of its own
+    /// relative to the array start (the CLR does not align array data itself further than 8 or 16 bytes).
+    /// One thread writes (the stream's), readers take windows without locking, see HistoryWindow.IsIntact.
+    /// </summary>
+    public class SensorHistory
+    {
+        /// <summary>
+        /// Floats per 64 byte cache line, capacities are rounded to it.
+        /// </summary>
+        public const int Alignment = 16;
+
+        private readonly float[] _data;
+        private readonly uint[] _timeStamps;
+        private readonly HistoryFieldEnum[] _fields;
+        private readonly int[] _columnOffsets;
+
+        private long _written;
+        private int _next;
+
+        public SensorStream Stream { get; private set; }
+
+        public IList<HistoryFieldEnum> Fields { get { return _fields; } }
+
+        public int Capacity { get; private set; }
+
+        /// <summary>
+        /// Samples ever written.
+        /// </summary>
+        public long Written { get { return Volatile.Read(ref _written); } }
+
+        /// <summary>
+        /// Index of the oldest sample readers can rely on. The slot after the newest is the one being overwritten,
+        /// so Capacity - 1 samples are readable.
+        /// </summary>
+        public long Oldest { get { return Math.Max(0, Written + 1 - Capacity); } }
+
+        /// <summary>
+        /// Samples available to read.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                var written = Written;
+                return (int)(written - Math.Max(0, written + 1 - Capacity));
+            }
+        }
+
+        internal float[] Data { get { return _data; } }
+
+        internal uint[] TimeStamps { get { return _timeStamps; } }
+
+        /// <param name="stream">The stream the samples come from.</param>
+        /// <param name="capacity">Samples kept, rounded up to a multiple of Alignment.</param>
+        /// <param name="fields">The fields kept.</param>
+        public SensorHistory(SensorStream stream, int capacity, params HistoryFieldEnum[] fields)
+        {
+            if (capacity < 2) throw new ArgumentOutOfRangeException("capacity");
+            Stream = stream;
+            Capacity = (capacity + Alignment - 1) / Alignment * Alignment;
+            _fields = fields.Distinct().ToArray();
+            _columnOffsets = Enumerable.Repeat(-1, Enum.GetValues(typeof(HistoryFieldEnum)).Length).ToArray();
+            for (var i = 0; i < _fields.Length; i++) _columnOffsets[(int)_fields[i]] = i * Capacity;
+            _data = new float[_fields.Length * Capacity];
+            _timeStamps = new uint[Capacity];
+        }
+
+        public bool Contains(HistoryFieldEnum field)
+        {
+            return _columnOffsets[(int)field] >= 0;
+        }
+
+        /// <summary>
+        /// The newest samples, at most Count of them.
+        /// </summary>
+        public HistoryWindow Last(int samples)
+        {
+            if (samples < 0) throw new ArgumentOutOfRangeException("samples");
+            var written = Written;
+            var length = (int)Math.Min(samples, written - Math.Max(0, written + 1 - Capacity));
+            return new HistoryWindow(this, written - length, length);
+        }
+
+        /// <summary>
+        /// The samples with sensor timestamps from fromTimeStamp to toTimeStamp, inclusive.
+        /// Timestamps are taken to increase, wrapping around like the sensor's clock.
+        /// </summary>
+        public HistoryWindow Range(uint fromTimeStamp, uint toTimeStamp)
+        {
+            var written = Written;
+            var oldest = Math.Max(0, written + 1 - Capacity);
+            var start = FirstAfter(oldest, written, fromTimeStamp, false);
+            var end = FirstAfter(start, written, toTimeStamp, true);
+            return new HistoryWindow(this, start, (int)(end - start));
+        }
+
+        /// <summary>
+        /// Offset of the field's column in Data.
+        /// </summary>
+        internal int ColumnOffset(HistoryFieldEnum field)
+        {
+            var offset = _columnOffsets[(int)field];
+            if (offset < 0) throw new ArgumentOutOfRangeException("field", "The field is not kept.");
+            return offset;
+        }
+
+        internal void Append(ref SensorSample sample)
+        {
+            var slot = _next;
+            _timeStamps[slot] = sample.TimeStamp;
+            for (var i = 0; i < _fields.Length; i++) _data[i * Capacity + slot] = Value(_fields[i], ref sample);
+            _next = slot + 1 == Capacity ? 0 : slot + 1;
+            //Publish after the values are in place.
+            Volatile.Write(ref _written, _written + 1);
+        }
+
+        /// <summary>
+        /// Index of the first sample from first to end with a timestamp at (or, if after, past) the given one.
+        /// </summary>
+        private long FirstAfter(long first, long end, uint timeStamp, bool after)
+        {
+            while (first < end)
+            {
+                var middle = first + (end - first) / 2;
+                var difference = unchecked((int)(_timeStamps[middle % Capacity] - timeStamp));
+                if (difference < 0 || (after && difference == 0)) first = middle + 1;
+                else end = middle;
+            }
+            return first;
+        }
+
+        private static float Value(HistoryFieldEnum field, ref SensorSample sample)
+        {
+            switch (field)
+            {
+                case HistoryFieldEnum.QuaternionX: return sample.Quaternion.X;
+                case HistoryFieldEnum.QuaternionY: return sample.Quaternion.Y;
+                case HistoryFieldEnum.QuaternionZ: return sample.Quaternion.Z;
+                case HistoryFieldEnum.QuaternionW: return sample.Quaternion.W;
+                case HistoryFieldEnum.GyroX: return sample.Gyro.X;
+                case HistoryFieldEnum.GyroY: return sample.Gyro.Y;
+                case HistoryFieldEnum.GyroZ: return sample.Gyro.Z;
+                case HistoryFieldEnum.AccelerometerX: return sample.Accelerometer.X;
+                case HistoryFieldEnum.AccelerometerY: return sample.Accelerometer.Y;
+                case HistoryFieldEnum.AccelerometerZ: return sample.Accelerometer.Z;
+                case HistoryFieldEnum.CompassX: return sample.Compass.X;
+                case HistoryFieldEnum.CompassY: return sample.Compass.Y;
+                default: return sample.Compass.Z;
+            }
+        }
+    }
+}
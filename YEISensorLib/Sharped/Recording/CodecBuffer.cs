@@ -0,0 +1,78 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Growable byte buffer with the varint and zigzag primitives of the stream log codec.
+    /// </summary>
+    internal class CodecBuffer
+    {
+        public byte[] Data;
+        public int Position;
+
+        public CodecBuffer(int capacity)
+        {
+            Data = new byte[capacity];
+        }
+
+        public CodecBuffer(byte[] data, int position)
+        {
+            Data = data;
+            Position = position;
+        }
+
+        public void Ensure(int extra)
+        {
+            if (Position + extra <= Data.Length) return;
+            var data = new byte[Math.Max(Data.Length * 2, Position + extra)];
+            Buffer.BlockCopy(Data, 0, data, 0, Position);
+            Data = data;
+        }
+
+        /// <summary>
+        /// Write without a capacity check, callers Ensure 5 bytes per value up front.
+        /// </summary>
+        public void WriteVarUInt(uint value)
+        {
+            while (value >= 0x80)
+            {
+                Data[Position++] = (byte)(value | 0x80);
+                value >>= 7;
+            }
+            Data[Position++] = (byte)value;
+        }
+
+        public uint ReadVarUInt()
+        {
+            uint value = 0;
+            var shift = 0;
+            byte b;
+            do
+            {
+                b = Data[Position++];
+                value |= (uint)(b & 0x7f) << shift;
+                shift += 7;
+            } while (b >= 0x80);
+            return value;
+        }
+
+        public static uint ZigZag(int value)
+        {
+            return (uint)((value << 1) ^ (value >> 31));
+        }
+
+        public static int UnZigZag(uint value)
+        {
+            return (int)(value >> 1) ^ -(int)(value & 1);
+        }
+
+        public static int VarUIntSize(uint value)
+        {
+            return value < 0x80 ? 1 : value < 0x4000 ? 2 : value < 0x200000 ? 3 : value < 0x10000000 ? 4 : 5;
+        }
+    }
+}
@@ -0,0 +1,28 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Index entry of one block of a compressed session log.
+    /// </summary>
+    public struct CompressedBlockInfo
+    {
+        /// <summary>
+        /// File offset of the block header.
+        /// </summary>
+        public long Offset;
+
+        /// <summary>
+        /// Index of the block's first record within the log.
+        /// </summary>
+        public long FirstRecord;
+
+        public int RecordCount;
+        public uint FirstTimeStamp;
+        public uint LastTimeStamp;
+    }
+}
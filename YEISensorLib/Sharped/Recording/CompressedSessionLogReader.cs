@@ -0,0 +1,262 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Reads the records of a compressed session log, decoding one block at a time.
+    /// Seeking only decodes the block holding the wanted record.
+    /// </summary>
+    public class CompressedSessionLogReader : ISessionLogReader
+    {
+        private const int BufferSize = 1 << 20;
+        private const int FooterSize = 16;
+
+        private bool _isDisposed;
+
+        private readonly Stream _stream;
+        private readonly BinaryReader _reader;
+        private readonly StreamLogCodec _codec;
+        private readonly List<CompressedBlockInfo> _blocks = new List<CompressedBlockInfo>();
+
+        private byte[] _compressed = new byte[0];
+        private readonly byte[] _decoded;
+        private int _block = -1;
+        private int _decodedCount;
+        private int _next;
+
+        /// <summary>
+        /// Returns true if the file is a compressed session log this version can read.
+        /// </summary>
+        public bool IsValid { get; private set; }
+
+        public SessionLogHeader Header { get; private set; }
+
+        public StreamLogCodecOptions Options { get; private set; }
+
+        /// <summary>
+        /// Number of complete records in the file.
+        /// </summary>
+        public long RecordCount { get; private set; }
+
+        public IList<CompressedBlockInfo> Blocks { get; private set; }
+
+        public CompressedSessionLogReader(string path)
+            : this(new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite, BufferSize, FileOptions.RandomAccess))
+        {
+        }
+
+        /// <summary>
+        /// Read a compressed session log from a seekable stream, which is closed on Dispose.
+        /// </summary>
+        public CompressedSessionLogReader(Stream stream)
+        {
+            _stream = stream;
+            _reader = new BinaryReader(_stream);
+            Blocks = new ReadOnlyCollection<CompressedBlockInfo>(_blocks);
+
+            if (_stream.Length < 20 || _reader.ReadInt32() != CompressedSessionLogWriter.Magic || _reader.ReadInt32() != CompressedSessionLogWriter.Version) return;
+            Options = new StreamLogCodecOptions
+                          {
+                              QuaternionErrorBound = _reader.ReadSingle(),
+                              ComponentResolution = _reader.ReadSingle(),
+                              RecordsPerBlock = _reader.ReadInt32(),
+                          };
+            if (Options.RecordsPerBlock <= 0) return;
+            Header = SessionLogHeader.Read(_reader);
+            if (Header == null) return;
+
+            if (!ReadIndex()) ScanBlocks();
+            _codec = new StreamLogCodec(Header.Layout, Options);
+            _decoded = new byte[Options.RecordsPerBlock * Header.RecordSize];
+            IsValid = true;
+        }
+
+        private bool ReadIndex()
+        {
+            var dataStart = _stream.Position;
+            if (_stream.Length - dataStart < FooterSize) return false;
+
+            _stream.Position = _stream.Length - FooterSize;
+            var blockCount = _reader.ReadInt32();
+            var indexOffset = _reader.ReadInt64();
+            if (_reader.ReadInt32() != CompressedSessionLogWriter.Magic
+                || indexOffset < dataStart
+                || _stream.Length - FooterSize - indexOffset != blockCount * 20L)
+            {
+                _stream.Position = dataStart;
+                return false;
+            }
+
+            _stream.Position = indexOffset;
+            for (var i = 0; i < blockCount; i++)
+            {
+                AddBlock(new CompressedBlockInfo
+                             {
+                                 Offset = _reader.ReadInt64(),
+                                 RecordCount = _reader.ReadInt32(),
+                                 FirstTimeStamp = _reader.ReadUInt32(),
+                                 LastTimeStamp = _reader.ReadUInt32(),
+                             });
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Rebuild the index of a log that was not closed, ignoring a partly written last block.
+        /// </summary>
+        private void ScanBlocks()
+        {
+            var position = _stream.Position;
+            while (_stream.Length - position >= CompressedSessionLogWriter.BlockHeaderSize)
+            {
+                _stream.Position = position;
+                var bodyLength = _reader.ReadInt32();
+                var block = new CompressedBlockInfo
+                                {
+                                    Offset = position,
+                                    RecordCount = _reader.ReadInt32(),
+                                    FirstTimeStamp = _reader.ReadUInt32(),
+                                    LastTimeStamp = _reader.ReadUInt32(),
+                                };
+                if (bodyLength < 0 || block.RecordCount <= 0 || block.RecordCount > Options.RecordsPerBlock) break;
+                position += CompressedSessionLogWriter.BlockHeaderSize + bodyLength;
+                if (position > _stream.Length) break;
+                AddBlock(block);
+            }
+        }
+
+        private void AddBlock(CompressedBlockInfo block)
+        {
+            block.FirstRecord = RecordCount;
+            RecordCount += block.RecordCount;
+            _blocks.Add(block);
+        }
+
+        /// <summary>
+        /// Index of the block holding a record, -1 if out of range.
+        /// </summary>
+        public int FindBlock(long recordIndex)
+        {
+            int low = 0, high = _blocks.Count - 1;
+            while (low <= high)
+            {
+                var middle = (low + high) / 2;
+                var block = _blocks[middle];
+                if (recordIndex < block.FirstRecord) high = middle - 1;
+                else if (recordIndex >= block.FirstRecord + block.RecordCount) low = middle + 1;
+                else return middle;
+            }
+            return -1;
+        }
+
+        /// <summary>
+        /// Decode a whole block into session log records (timestamp followed by payload).
+        /// </summary>
+        /// <param name="block">Index into Blocks.</param>
+        /// <param name="records">Receives the records, must hold Options.RecordsPerBlock * Header.RecordSize bytes.</param>
+        /// <returns>Number of records decoded.</returns>
+        public int ReadBlock(int block, byte[] records)
+        {
+            if (!IsValid) return 0;
+            var info = _blocks[block];
+            _stream.Position = info.Offset;
+            var bodyLength = _reader.ReadInt32();
+            if (_compressed.Length < bodyLength) _compressed = new byte[bodyLength];
+            _stream.Position = info.Offset + CompressedSessionLogWriter.BlockHeaderSize;
+            var read = 0;
+            while (read < bodyLength)
+            {
+                var n = _stream.Read(_compressed, read, bodyLength - read);
+                if (n == 0) return 0;
+                read += n;
+            }
+
+            _codec.Decode(new CodecBuffer(_compressed, 0), info.RecordCount, records, 0);
+            return info.RecordCount;
+        }
+
+        /// <summary>
+        /// Position the reader on a record.
+        /// </summary>
+        public void Seek(long recordIndex)
+        {
+            var block = FindBlock(recordIndex);
+            if (block < 0)
+            {
+                //Past the end
+                _block = _blocks.Count;
+                _decodedCount = _next = 0;
+                return;
+            }
+            Load(block);
+            _next = (int)(recordIndex - _blocks[block].FirstRecord);
+        }
+
+        private bool Load(int block)
+        {
+            _block = block;
+            _next = 0;
+            _decodedCount = block < _blocks.Count ? ReadBlock(block, _decoded) : 0;
+            return _decodedCount > 0;
+        }
+
+        private bool EnsureRecord()
+        {
+            while (_next >= _decodedCount)
+            {
+                if (_block + 1 >= _blocks.Count) return false;
+                if (!Load(_block + 1)) return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Read the next record.
+        /// </summary>
+        /// <param name="timeStamp">Timestamp of the packet.</param>
+        /// <param name="payload">Receives the stream data, must hold at least Header.Layout.PayloadSize bytes.</param>
+        /// <returns>False at the end of the log.</returns>
+        public bool ReadRecord(out uint timeStamp, byte[] payload)
+        {
+            timeStamp = 0;
+            if (!IsValid || !EnsureRecord()) return false;
+            var position = _next * Header.RecordSize;
+            timeStamp = BitConverter.ToUInt32(_decoded, position);
+            Buffer.BlockCopy(_decoded, position + 4, payload, 0, Header.Layout.PayloadSize);
+            _next++;
+            return true;
+        }
+
+        /// <summary>
+        /// Read as many whole records as fit into buffer.
+        /// </summary>
+        /// <returns>Number of records read, 0 at the end of the log.</returns>
+        public int ReadRecords(byte[] buffer)
+        {
+            if (!IsValid) return 0;
+            var wanted = buffer.Length / Header.RecordSize;
+            var read = 0;
+            while (read < wanted && EnsureRecord())
+            {
+                var take = Math.Min(wanted - read, _decodedCount - _next);
+                Buffer.BlockCopy(_decoded, _next * Header.RecordSize, buffer, read * Header.RecordSize, take * Header.RecordSize);
+                _next += take;
+                read += take;
+            }
+            return read;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            _reader.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
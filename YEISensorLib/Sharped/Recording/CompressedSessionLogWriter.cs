@@ -0,0 +1,236 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Writes a compressed session log (.ysc): the records of a session log, encoded in blocks by StreamLogCodec.
+    /// 
+    /// File layout:
+    ///     int Magic, int Version, float QuaternionErrorBound, float ComponentResolution, int RecordsPerBlock,
+    ///     the SessionLogHeader,
+    ///     blocks: int BodyLength, int RecordCount, uint FirstTimeStamp, uint LastTimeStamp, body,
+    ///     index: per block long Offset, int RecordCount, uint FirstTimeStamp, uint LastTimeStamp,
+    ///     int BlockCount, long IndexOffset, int Magic.
+    /// The index is written on Dispose. Without it (a crash) the reader rebuilds it from the block headers.
+    /// 
+    /// Can be added to a SensorStream as a sink, blocks are then encoded on the acquisition thread.
+    /// Packets laid out differently from Header.Layout (see SensorStream.SetLayout and SlotMultiplexer) are re-packed
+    /// slot by slot into it: slots the packet does not carry keep the last value recorded (zero until the first),
+    /// slots the header does not have are dropped. RepackedRecords counts them.
+    /// </summary>
+    public class CompressedSessionLogWriter : IStreamSink, IDisposable
+    {
+        public const int Magic = 0x31435359; //"YSC1"
+        public const int Version = 1;
+        public const int BlockHeaderSize = 16;
+
+        private const int BufferSize = 1 << 20;
+
+        private bool _isDisposed;
+
+        private readonly Stream _stream;
+        private readonly BinaryWriter _writer;
+        private readonly StreamLogCodec _codec;
+        private readonly byte[] _pending;
+        private int _pendingCount;
+        private readonly CodecBuffer _encoded;
+        private readonly List<CompressedBlockInfo> _blocks = new List<CompressedBlockInfo>();
+
+        //Last value of every header slot, and where the slots of the last seen packet layout go in it.
+        private readonly byte[] _lastPayload;
+        private StreamSlotLayout _packetLayout;
+        private int[] _packetOffsets;
+        private bool _packetMatchesHeader;
+
+        public SessionLogHeader Header { get; private set; }
+
+        public StreamLogCodecOptions Options { get; private set; }
+
+        /// <summary>
+        /// Number of records written so far.
+        /// </summary>
+        public long RecordCount { get; private set; }
+
+        /// <summary>
+        /// Records received as a sink with another layout than Header.Layout, re-packed into it.
+        /// </summary>
+        public long RepackedRecords { get; private set; }
+
+        /// <summary>
+        /// Size the records would have in an uncompressed session log.
+        /// </summary>
+        public long RawBytes
+        {
+            get { return Header.Size + RecordCount * Header.RecordSize; }
+        }
+
+        /// <summary>
+        /// Bytes written to the file so far, excluding records not yet encoded.
+        /// </summary>
+        public long CompressedBytes
+        {
+            get { return _stream.Position; }
+        }
+
+        /// <summary>
+        /// Create a new compressed session log, overwriting any existing file.
+        /// </summary>
+        public CompressedSessionLogWriter(string path, SessionLogHeader header, StreamLogCodecOptions options)
+            : this(new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.Read, BufferSize, FileOptions.SequentialScan), header, options)
+        {
+        }
+
+        /// <summary>
+        /// Write a compressed session log to a stream, which is closed on Dispose.
+        /// </summary>
+        public CompressedSessionLogWriter(Stream stream, SessionLogHeader header, StreamLogCodecOptions options)
+        {
+            if (options.RecordsPerBlock <= 0) throw new ArgumentOutOfRangeException("options", "RecordsPerBlock must be positive.");
+
+            Header = header;
+            Options = options;
+            _stream = stream;
+            _writer = new BinaryWriter(_stream);
+            _codec = new StreamLogCodec(header.Layout, options);
+            _pending = new byte[options.RecordsPerBlock * header.RecordSize];
+            _encoded = new CodecBuffer(_pending.Length + BlockHeaderSize);
+            _lastPayload = new byte[Math.Max(1, header.Layout.PayloadSize)];
+
+            _writer.Write(Magic);
+            _writer.Write(Version);
+            _writer.Write(options.QuaternionErrorBound);
+            _writer.Write(options.ComponentResolution);
+            _writer.Write(options.RecordsPerBlock);
+            header.Write(_writer);
+        }
+
+        /// <summary>
+        /// Append one stream packet.
+        /// </summary>
+        /// <param name="timeStamp">Timestamp of the packet.</param>
+        /// <param name="payload">Buffer holding the packet's stream data.</param>
+        /// <param name="offset">Offset of the packet within payload.</param>
+        public void WriteRecord(uint timeStamp, byte[] payload, int offset)
+        {
+            var position = _pendingCount * Header.RecordSize;
+            FloatBits.WriteInt32(_pending, position, (int)timeStamp);
+            Buffer.BlockCopy(payload, offset, _pending, position + 4, Header.Layout.PayloadSize);
+            Added(1);
+        }
+
+        /// <summary>
+        /// Append session log records (timestamp followed by payload).
+        /// </summary>
+        /// <param name="records">Buffer of back to back records.</param>
+        /// <param name="offset">Offset of the first record.</param>
+        /// <param name="count">Number of records.</param>
+        public void WriteRecords(byte[] records, int offset, int count)
+        {
+            while (count > 0)
+            {
+                var take = Math.Min(count, Options.RecordsPerBlock - _pendingCount);
+                Buffer.BlockCopy(records, offset, _pending, _pendingCount * Header.RecordSize, take * Header.RecordSize);
+                offset += take * Header.RecordSize;
+                count -= take;
+                Added(take);
+            }
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            var layout = stream.PacketLayout;
+            if (layout != _packetLayout) MapPacketLayout(layout);
+
+            if (_packetMatchesHeader)
+            {
+                Buffer.BlockCopy(payload, 0, _lastPayload, 0, Header.Layout.PayloadSize);
+            }
+            else
+            {
+                for (var slot = 0; slot < layout.Slots.Length; slot++)
+                {
+                    if (_packetOffsets[slot] < 0) continue;
+                    Buffer.BlockCopy(payload, layout.OffsetOfSlot(slot), _lastPayload, _packetOffsets[slot], StreamSlotLayout.ByteSize(layout.Slots[slot]));
+                }
+                RepackedRecords++;
+            }
+            WriteRecord(sample.TimeStamp, _lastPayload, 0);
+        }
+
+        private void MapPacketLayout(StreamSlotLayout layout)
+        {
+            _packetOffsets = layout.Slots.Select(c => Header.Layout.OffsetOf(c)).ToArray();
+            _packetMatchesHeader = layout.Slots.SequenceEqual(Header.Layout.Slots);
+            _packetLayout = layout;
+        }
+
+        private void Added(int count)
+        {
+            _pendingCount += count;
+            RecordCount += count;
+            if (_pendingCount == Options.RecordsPerBlock) WriteBlock();
+        }
+
+        private void WriteBlock()
+        {
+            if (_pendingCount == 0) return;
+
+            _encoded.Position = BlockHeaderSize;
+            _codec.Encode(_pending, 0, _pendingCount, _encoded);
+
+            var block = new CompressedBlockInfo
+                            {
+                                Offset = _stream.Position,
+                                FirstRecord = RecordCount - _pendingCount,
+                                RecordCount = _pendingCount,
+                                FirstTimeStamp = (uint)FloatBits.ReadInt32(_pending, 0),
+                                LastTimeStamp = (uint)FloatBits.ReadInt32(_pending, (_pendingCount - 1) * Header.RecordSize),
+                            };
+            FloatBits.WriteInt32(_encoded.Data, 0, _encoded.Position - BlockHeaderSize);
+            FloatBits.WriteInt32(_encoded.Data, 4, block.RecordCount);
+            FloatBits.WriteInt32(_encoded.Data, 8, (int)block.FirstTimeStamp);
+            FloatBits.WriteInt32(_encoded.Data, 12, (int)block.LastTimeStamp);
+            _writer.Write(_encoded.Data, 0, _encoded.Position);
+
+            _blocks.Add(block);
+            _pendingCount = 0;
+        }
+
+        /// <summary>
+        /// Encode the records received so far as a (short) block and flush the file.
+        /// </summary>
+        public void Flush()
+        {
+            WriteBlock();
+            _writer.Flush();
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            WriteBlock();
+
+            var indexOffset = _stream.Position;
+            foreach (var block in _blocks)
+            {
+                _writer.Write(block.Offset);
+                _writer.Write(block.RecordCount);
+                _writer.Write(block.FirstTimeStamp);
+                _writer.Write(block.LastTimeStamp);
+            }
+            _writer.Write(_blocks.Count);
+            _writer.Write(indexOffset);
+            _writer.Write(Magic);
+
+            _writer.Flush();
+            _writer.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
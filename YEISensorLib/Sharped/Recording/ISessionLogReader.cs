@@ -0,0 +1,35 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Reads session log records, whatever the file format.
+    /// </summary>
+    public interface ISessionLogReader : IDisposable
+    {
+        bool IsValid { get; }
+
+        SessionLogHeader Header { get; }
+
+        long RecordCount { get; }
+
+        /// <summary>
+        /// Position the reader on a record.
+        /// </summary>
+        void Seek(long recordIndex);
+
+        /// <summary>
+        /// Read the next record, false at the end of the log.
+        /// </summary>
+        bool ReadRecord(out uint timeStamp, byte[] payload);
+
+        /// <summary>
+        /// Read as many whole records (timestamp followed by payload) as fit into buffer, 0 at the end of the log.
+        /// </summary>
+        int ReadRecords(byte[] buffer);
+    }
+}
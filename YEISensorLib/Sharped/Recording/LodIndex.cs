@@ -0,0 +1,134 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// A pyramid of LodSummary entries over a session.
+    /// Level 0 summarizes BlockRecords records per entry, each level above merges FanOut entries of the level below.
+    /// Any window at any zoom is answered from a level giving at most maxPoints points. The level is picked
+    /// from the window length, so a query usually touches its entries plus two binary searches, however long the session.
+    /// </summary>
+    public abstract class LodIndex
+    {
+        public const string Extension = ".lod";
+
+        /// <summary>
+        /// Records per level 0 entry.
+        /// </summary>
+        public int BlockRecords { get; protected set; }
+
+        /// <summary>
+        /// Entries of a level merged into one entry of the level above.
+        /// </summary>
+        public int FanOut { get; protected set; }
+
+        /// <summary>
+        /// Records summarized by the index.
+        /// </summary>
+        public long RecordCount { get; protected set; }
+
+        public abstract int LevelCount { get; }
+
+        public abstract int EntryCount(int level);
+
+        public abstract LodSummary Entry(int level, int index);
+
+        /// <summary>
+        /// Records per entry at a level (the last entry may hold fewer).
+        /// </summary>
+        public long RecordsPerEntry(int level)
+        {
+            long records = BlockRecords;
+            for (var i = 0; i < level; i++) records *= FanOut;
+            return records;
+        }
+
+        /// <summary>
+        /// Index of the first record of an entry, to read the raw records behind it from the session log.
+        /// </summary>
+        public long FirstRecord(int level, int index)
+        {
+            return index * RecordsPerEntry(level);
+        }
+
+        /// <summary>
+        /// Summaries of [fromTime, toTime], at most maxPoints entries.
+        /// The level is estimated from the window's share of the session, so it may be one coarser than the finest that
+        /// fits; where the sample rate was higher than average the next levels up are searched too. The top level is a
+        /// single entry, so the bound always holds.
+        /// </summary>
+        /// <param name="fromTime">Microseconds from the start of the session.</param>
+        /// <param name="toTime">Microseconds from the start of the session.</param>
+        /// <param name="maxPoints">Maximum number of entries wanted, e.g. the pixel width of the view.</param>
+        /// <param name="level">The level the entries come from.</param>
+        public virtual LodSummary[] Query(long fromTime, long toTime, int maxPoints, out int level)
+        {
+            if (maxPoints <= 0) throw new ArgumentOutOfRangeException("maxPoints");
+
+            level = 0;
+            var levels = LevelCount;
+            if (levels == 0 || toTime < fromTime) return new LodSummary[0];
+
+            //The top level's single entry spans the whole session.
+            var duration = Entry(levels - 1, EntryCount(levels - 1) - 1).LastTime;
+            if (duration > 0)
+            {
+                var windowRecords = (double)RecordCount * (Math.Min(toTime, duration) - Math.Max(fromTime, 0)) / duration;
+                //A window k entries long overlaps up to k + 1 of them.
+                while (level < levels - 1 && windowRecords / RecordsPerEntry(level) + 1 > maxPoints) level++;
+            }
+
+            int first, end;
+            Range(level, fromTime, toTime, out first, out end);
+            while (end - first > maxPoints && level < levels - 1)
+            {
+                level++;
+                Range(level, fromTime, toTime, out first, out end);
+            }
+
+            var result = new LodSummary[Math.Max(0, end - first)];
+            for (var i = 0; i < result.Length; i++) result[i] = Entry(level, first + i);
+            return result;
+        }
+
+        /// <summary>
+        /// Entries [first, end) of a level overlapping [fromTime, toTime].
+        /// </summary>
+        public void Range(int level, long fromTime, long toTime, out int first, out int end)
+        {
+            var count = EntryCount(level);
+
+            //First entry whose LastTime reaches fromTime
+            int low = 0, high = count;
+            while (low < high)
+            {
+                var middle = (low + high) / 2;
+                if (Entry(level, middle).LastTime < fromTime) low = middle + 1;
+                else high = middle;
+            }
+            first = low;
+
+            //First entry starting after toTime
+            high = count;
+            while (low < high)
+            {
+                var middle = (low + high) / 2;
+                if (Entry(level, middle).FirstTime <= toTime) low = middle + 1;
+                else high = middle;
+            }
+            end = low;
+        }
+
+        /// <summary>
+        /// The index file kept alongside a session log.
+        /// </summary>
+        public static string PathFor(string sessionLogPath)
+        {
+            return sessionLogPath + Extension;
+        }
+    }
+}
@@ -0,0 +1,368 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Builds a level of detail index while recording, in O(1) amortized per sample:
+    /// each level keeps one partial entry, and a completed entry is folded into the partial entry of the level above.
+    /// The index can be queried while it grows (partial entries included) and saved next to the session log.
+    /// 
+    /// Usage, alongside a SessionLogWriter:
+    ///     var index = new LodIndexBuilder(64, 4);
+    ///     stream.AddSink(log);
+    ///     stream.AddSink(index);
+    ///     ...
+    ///     index.Save(LodIndex.PathFor(logPath));
+    /// 
+    /// File layout (read by LodIndexReader):
+    ///     int Magic, int Version, int BlockRecords, int FanOut, long RecordCount, int LevelCount, int EntrySize,
+    ///     per level: long Offset, int Count, int 0,
+    ///     the entries of each level, as LodSummary structs.
+    /// </summary>
+    public class LodIndexBuilder : LodIndex, IStreamSink
+    {
+        public const int Magic = 0x31444c59; //"YLD1"
+        public const int Version = 1;
+        public const int HeaderSize = 32;
+        public const int LevelEntrySize = 16;
+
+        private readonly object _lock = new object();
+        private readonly List<List<LodSummary>> _levels = new List<List<LodSummary>>();
+        private readonly List<Accumulator> _partials = new List<Accumulator>();
+
+        private long _elapsed;
+        private uint _lastTimeStamp;
+
+        private readonly Dictionary<int, LodSummary> _tails = new Dictionary<int, LodSummary>();
+        private long _tailRecordCount = -1;
+
+        /// <param name="blockRecords">Records per level 0 entry.</param>
+        /// <param name="fanOut">Entries merged per entry of the next level, at least 2.</param>
+        public LodIndexBuilder(int blockRecords, int fanOut)
+        {
+            if (blockRecords <= 0) throw new ArgumentOutOfRangeException("blockRecords");
+            if (fanOut < 2) throw new ArgumentOutOfRangeException("fanOut");
+            BlockRecords = blockRecords;
+            FanOut = fanOut;
+        }
+
+        public override int LevelCount
+        {
+            get { lock (_lock) return _levels.Count; }
+        }
+
+        public override int EntryCount(int level)
+        {
+            lock (_lock) return _levels[level].Count + (HasTail(level) ? 1 : 0);
+        }
+
+        public override LodSummary Entry(int level, int index)
+        {
+            lock (_lock)
+            {
+                var completed = _levels[level];
+                return index < completed.Count ? completed[index] : Tail(level);
+            }
+        }
+
+        /// <summary>
+        /// Answered under one lock, so samples added meanwhile wait and cannot shift the entries between the searches.
+        /// </summary>
+        public override LodSummary[] Query(long fromTime, long toTime, int maxPoints, out int level)
+        {
+            lock (_lock) return base.Query(fromTime, toTime, maxPoints, out level);
+        }
+
+        /// <summary>
+        /// True if some records are not yet in a completed entry of the level.
+        /// </summary>
+        private bool HasTail(int level)
+        {
+            for (var k = 0; k <= level; k++)
+            {
+                if (_partials[k].Count > 0) return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// The records not yet in a completed entry of the level: its partial entry plus the partial entries below it.
+        /// </summary>
+        private LodSummary Tail(int level)
+        {
+            if (_tailRecordCount != RecordCount)
+            {
+                _tails.Clear();
+                _tailRecordCount = RecordCount;
+            }
+
+            LodSummary tail;
+            if (_tails.TryGetValue(level, out tail)) return tail;
+
+            var accumulator = _partials[level].Clone();
+            if (level > 0 && HasTail(level - 1))
+            {
+                var below = Tail(level - 1);
+                accumulator.AddSummary(ref below);
+            }
+            tail = accumulator.ToSummary();
+            _tails[level] = tail;
+            return tail;
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            Add(ref sample);
+        }
+
+        /// <summary>
+        /// Add the next sample of the session.
+        /// </summary>
+        public void Add(ref SensorSample sample)
+        {
+            lock (_lock)
+            {
+                if (RecordCount > 0) _elapsed += SensorClock.ElapsedMicroseconds(_lastTimeStamp, sample.TimeStamp);
+                _lastTimeStamp = sample.TimeStamp;
+                RecordCount++;
+
+                if (_levels.Count == 0) AddLevel();
+                var block = _partials[0];
+                block.AddSample(_elapsed, ref sample);
+                if (block.Count == BlockRecords) Complete(0);
+            }
+        }
+
+        private void AddLevel()
+        {
+            _levels.Add(new List<LodSummary>());
+            _partials.Add(new Accumulator());
+        }
+
+        private void Complete(int level)
+        {
+            var summary = _partials[level].ToSummary();
+            _partials[level].Reset();
+            _levels[level].Add(summary);
+
+            if (level + 1 == _levels.Count) AddLevel();
+            var parent = _partials[level + 1];
+            parent.AddSummary(ref summary);
+            if (parent.Children == FanOut) Complete(level + 1);
+        }
+
+        /// <summary>
+        /// Write the index (including partial entries) to a file, replacing it.
+        /// </summary>
+        public void Save(string path)
+        {
+            lock (_lock)
+            {
+                var entrySize = Marshal.SizeOf(typeof(LodSummary));
+                var levelCount = _levels.Count;
+                var counts = Enumerable.Range(0, levelCount).Select(EntryCount).ToArray();
+                var capacity = HeaderSize + (long)levelCount * LevelEntrySize + counts.Sum(c => (long)c) * entrySize;
+
+                var temporary = path + ".tmp";
+                using (var file = MemoryMappedFile.CreateFromFile(temporary, FileMode.Create, null, capacity, MemoryMappedFileAccess.ReadWrite))
+                using (var view = file.CreateViewAccessor(0, capacity))
+                {
+                    view.Write(0, Magic);
+                    view.Write(4, Version);
+                    view.Write(8, BlockRecords);
+                    view.Write(12, FanOut);
+                    view.Write(16, RecordCount);
+                    view.Write(24, levelCount);
+                    view.Write(28, entrySize);
+
+                    long offset = HeaderSize + levelCount * LevelEntrySize;
+                    for (var level = 0; level < levelCount; level++)
+                    {
+                        view.Write(HeaderSize + level * LevelEntrySize, offset);
+                        view.Write(HeaderSize + level * LevelEntrySize + 8, counts[level]);
+                        view.Write(HeaderSize + level * LevelEntrySize + 12, 0);
+                        for (var i = 0; i < counts[level]; i++, offset += entrySize)
+                        {
+                            var entry = Entry(level, i);
+                            view.Write(offset, ref entry);
+                        }
+                    }
+                    view.Flush();
+                }
+
+                if (File.Exists(path)) File.Delete(path);
+                File.Move(temporary, path);
+            }
+        }
+
+        /// <summary>
+        /// Index an existing session log, read from its current position.
+        /// </summary>
+        public static LodIndexBuilder Build(ISessionLogReader log, int blockRecords, int fanOut)
+        {
+            var builder = new LodIndexBuilder(blockRecords, fanOut);
+            if (!log.IsValid) return builder;
+
+            var layout = log.Header.Layout;
+            var recordSize = log.Header.RecordSize;
+            var buffer = new byte[4096 * recordSize];
+            var sample = new SensorSample();
+            int count;
+            while ((count = log.ReadRecords(buffer)) > 0)
+            {
+                for (var i = 0; i < count; i++)
+                {
+                    layout.Decode(buffer, i * recordSize + 4, BitConverter.ToUInt32(buffer, i * recordSize), ref sample);
+                    builder.Add(ref sample);
+                }
+            }
+            return builder;
+        }
+
+        /// <summary>
+        /// The entry being built at one level.
+        /// </summary>
+        private class Accumulator
+        {
+            public int Count;
+            public int Children;
+
+            private long _firstTime;
+            private long _lastTime;
+            private Quaternion _reference;
+            private double _qx, _qy, _qz, _qw;
+            private float[] _min = new float[9];
+            private float[] _max = new float[9];
+            private double[] _sum = new double[9];
+            private float[] _values = new float[9];
+
+            public Accumulator Clone()
+            {
+                var clone = (Accumulator)MemberwiseClone();
+                clone._min = (float[])_min.Clone();
+                clone._max = (float[])_max.Clone();
+                clone._sum = (double[])_sum.Clone();
+                clone._values = new float[9];
+                return clone;
+            }
+
+            public void Reset()
+            {
+                Count = 0;
+                Children = 0;
+                _qx = _qy = _qz = _qw = 0;
+                Array.Clear(_sum, 0, 9);
+            }
+
+            public void AddSample(long time, ref SensorSample sample)
+            {
+                Begin(time, sample.Quaternion);
+                _lastTime = time;
+                AddQuaternion(sample.Quaternion, 1);
+
+                Set(0, sample.Gyro);
+                Set(3, sample.Accelerometer);
+                Set(6, sample.Compass);
+                for (var i = 0; i < 9; i++)
+                {
+                    var value = _values[i];
+                    if (Count == 0 || value < _min[i]) _min[i] = value;
+                    if (Count == 0 || value > _max[i]) _max[i] = value;
+                    _sum[i] += value;
+                }
+                Count++;
+            }
+
+            public void AddSummary(ref LodSummary summary)
+            {
+                Begin(summary.FirstTime, summary.Quaternion);
+                _lastTime = summary.LastTime;
+                AddQuaternion(summary.Quaternion, summary.Count);
+
+                Merge(0, summary.GyroMin, summary.GyroMax, summary.GyroMean, summary.Count);
+                Merge(3, summary.AccelerometerMin, summary.AccelerometerMax, summary.AccelerometerMean, summary.Count);
+                Merge(6, summary.CompassMin, summary.CompassMax, summary.CompassMean, summary.Count);
+                Count += summary.Count;
+                Children++;
+            }
+
+            public LodSummary ToSummary()
+            {
+                var norm = Math.Sqrt(_qx * _qx + _qy * _qy + _qz * _qz + _qw * _qw);
+                var scale = norm > 0 ? 1 / norm : 0;
+                var summary = new LodSummary
+                                  {
+                                      FirstTime = _firstTime,
+                                      LastTime = _lastTime,
+                                      Count = Count,
+                                      Quaternion = new Quaternion { X = (float)(_qx * scale), Y = (float)(_qy * scale), Z = (float)(_qz * scale), W = (float)(_qw * scale) },
+                                      GyroMin = Vector(_min, 0), GyroMax = Vector(_max, 0), GyroMean = Mean(0),
+                                      AccelerometerMin = Vector(_min, 3), AccelerometerMax = Vector(_max, 3), AccelerometerMean = Mean(3),
+                                      CompassMin = Vector(_min, 6), CompassMax = Vector(_max, 6), CompassMean = Mean(6),
+                                  };
+                return summary;
+            }
+
+            private void Begin(long time, Quaternion quaternion)
+            {
+                if (Count > 0) return;
+                _firstTime = time;
+                _reference = quaternion;
+            }
+
+            private void AddQuaternion(Quaternion q, double weight)
+            {
+                //q and -q are the same orientation, average them on the reference's side.
+                var dot = q.X * _reference.X + q.Y * _reference.Y + q.Z * _reference.Z + q.W * _reference.W;
+                if (dot < 0) weight = -weight;
+                _qx += q.X * weight;
+                _qy += q.Y * weight;
+                _qz += q.Z * weight;
+                _qw += q.W * weight;
+            }
+
+            private void Set(int offset, Vector3F vector)
+            {
+                _values[offset] = vector.X;
+                _values[offset + 1] = vector.Y;
+                _values[offset + 2] = vector.Z;
+            }
+
+            private void Merge(int offset, Vector3F min, Vector3F max, Vector3F mean, int count)
+            {
+                Set(offset, min);
+                for (var i = offset; i < offset + 3; i++)
+                {
+                    if (Count == 0 || _values[i] < _min[i]) _min[i] = _values[i];
+                }
+                Set(offset, max);
+                for (var i = offset; i < offset + 3; i++)
+                {
+                    if (Count == 0 || _values[i] > _max[i]) _max[i] = _values[i];
+                }
+                Set(offset, mean);
+                for (var i = offset; i < offset + 3; i++) _sum[i] += (double)_values[i] * count;
+            }
+
+            private Vector3F Mean(int offset)
+            {
+                var count = Math.Max(1, Count);
+                return new Vector3F { X = (float)(_sum[offset] / count), Y = (float)(_sum[offset + 1] / count), Z = (float)(_sum[offset + 2] / count) };
+            }
+
+            private static Vector3F Vector(float[] values, int offset)
+            {
+                return new Vector3F { X = values[offset], Y = values[offset + 1], Z = values[offset + 2] };
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// A saved level of detail index, memory mapped: entries are read in place, only the pages a query touches are loaded.
+    /// </summary>
+    public class LodIndexReader : LodIndex, IDisposable
+    {
+        private bool _isDisposed;
+
+        private readonly MemoryMappedFile _file;
+        private readonly MemoryMappedViewAccessor _view;
+        private readonly long[] _offsets = new long[0];
+        private readonly int[] _counts = new int[0];
+        private readonly int _entrySize;
+
+        /// <summary>
+        /// Returns true if the file is an index this version can read.
+        /// </summary>
+        public bool IsValid { get; private set; }
+
+        public LodIndexReader(string path)
+        {
+            if (!File.Exists(path) || new FileInfo(path).Length < LodIndexBuilder.HeaderSize) return;
+
+            _file = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+            _view = _file.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read);
+            if (_view.ReadInt32(0) != LodIndexBuilder.Magic || _view.ReadInt32(4) != LodIndexBuilder.Version) return;
+
+            _entrySize = _view.ReadInt32(28);
+            if (_entrySize != Marshal.SizeOf(typeof(LodSummary))) return;
+            BlockRecords = _view.ReadInt32(8);
+            FanOut = _view.ReadInt32(12);
+            RecordCount = _view.ReadInt64(16);
+
+            var levelCount = _view.ReadInt32(24);
+            if (levelCount < 0 || LodIndexBuilder.HeaderSize + (long)levelCount * LodIndexBuilder.LevelEntrySize > _view.Capacity) return;
+            _offsets = new long[levelCount];
+            _counts = new int[levelCount];
+            for (var level = 0; level < levelCount; level++)
+            {
+                var entry = LodIndexBuilder.HeaderSize + level * LodIndexBuilder.LevelEntrySize;
+                _offsets[level] = _view.ReadInt64(entry);
+                _counts[level] = _view.ReadInt32(entry + 8);
+                if (_counts[level] < 0 || _offsets[level] + (long)_counts[level] * _entrySize > _view.Capacity) return;
+            }
+            IsValid = true;
+        }
+
+        public override int LevelCount
+        {
+            get { return IsValid ? _counts.Length : 0; }
+        }
+
+        public override int EntryCount(int level)
+        {
+            return _counts[level];
+        }
+
+        public override LodSummary Entry(int level, int index)
+        {
+            LodSummary entry;
+            _view.Read(_offsets[level] + (long)index * _entrySize, out entry);
+            return entry;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            if (_view != null) _view.Dispose();
+            if (_file != null) _file.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
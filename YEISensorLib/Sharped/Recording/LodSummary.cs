@@ -0,0 +1,50 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Summary of a run of consecutive records, one entry of a level of detail index.
+    /// Blittable, it is read straight out of the memory mapped index file.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct LodSummary
+    {
+        /// <summary>
+        /// Microseconds from the start of the session to the first record (sensor timestamps, unwrapped).
+        /// </summary>
+        public long FirstTime;
+
+        /// <summary>
+        /// Microseconds from the start of the session to the last record.
+        /// </summary>
+        public long LastTime;
+
+        /// <summary>
+        /// Number of records summarized.
+        /// </summary>
+        public int Count;
+
+        private int _reserved;
+
+        /// <summary>
+        /// The normalized average orientation (quaternions sign aligned to the first one).
+        /// </summary>
+        public Quaternion Quaternion;
+
+        public Vector3F GyroMin;
+        public Vector3F GyroMax;
+        public Vector3F GyroMean;
+        public Vector3F AccelerometerMin;
+        public Vector3F AccelerometerMax;
+        public Vector3F AccelerometerMean;
+        public Vector3F CompassMin;
+        public Vector3F CompassMax;
+        public Vector3F CompassMean;
+    }
+}
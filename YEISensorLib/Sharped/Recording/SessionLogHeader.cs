@@ -0,0 +1,83 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Header of a session log file.
+    /// 
+    /// A session log holds the stream packets of one sensor as fixed size records:
+    ///     uint TimeStamp, followed by Layout.PayloadSize bytes of stream data (host byte order).
+    /// </summary>
+    public class SessionLogHeader
+    {
+        public const int Magic = 0x314c5359; //"YSL1"
+        public const int Version = 1;
+
+        /// <summary>
+        /// Serial number of the recorded sensor.
+        /// </summary>
+        public uint SerialNumber { get; private set; }
+
+        /// <summary>
+        /// The streaming slots each record carries.
+        /// </summary>
+        public StreamSlotLayout Layout { get; private set; }
+
+        /// <summary>
+        /// Size in bytes of one record.
+        /// </summary>
+        public int RecordSize
+        {
+            get { return 4 + Layout.PayloadSize; }
+        }
+
+        /// <summary>
+        /// Size in bytes of the header, records start at this offset.
+        /// </summary>
+        public int Size
+        {
+            get { return 16 + (Layout.Slots.Length + 3) / 4 * 4; }
+        }
+
+        public SessionLogHeader(uint serialNumber, StreamSlotLayout layout)
+        {
+            SerialNumber = serialNumber;
+            Layout = layout;
+        }
+
+        public void Write(BinaryWriter writer)
+        {
+            writer.Write(Magic);
+            writer.Write(Version);
+            writer.Write(SerialNumber);
+            writer.Write(Layout.Slots.Length);
+            foreach (var slot in Layout.Slots) writer.Write((byte)slot);
+            for (var i = Layout.Slots.Length; i < (Layout.Slots.Length + 3) / 4 * 4; i++) writer.Write((byte)0);
+        }
+
+        /// <summary>
+        /// Reads a header, returns null if the stream is not a session log.
+        /// </summary>
+        public static SessionLogHeader Read(BinaryReader reader)
+        {
+            if (reader.BaseStream.Length < 16) return null;
+            if (reader.ReadInt32() != Magic) return null;
+            if (reader.ReadInt32() != Version) return null;
+            var serialNumber = reader.ReadUInt32();
+            var slotCount = reader.ReadInt32();
+            if (slotCount < 0 || slotCount > 255) return null;
+
+            var slots = reader.ReadBytes((slotCount + 3) / 4 * 4);
+            var commands = new StreamCommandEnum[slotCount];
+            for (var i = 0; i < slotCount; i++) commands[i] = (StreamCommandEnum)slots[i];
+            return new SessionLogHeader(serialNumber, new StreamSlotLayout(commands));
+        }
+    }
+}
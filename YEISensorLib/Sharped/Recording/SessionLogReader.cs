@@ -0,0 +1,115 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Reads the records of a session log file.
+    /// </summary>
+    public class SessionLogReader : ISessionLogReader
+    {
+        private const int BufferSize = 1 << 20;
+
+        private bool _isDisposed;
+
+        private readonly FileStream _stream;
+        private readonly BinaryReader _reader;
+
+        //File length as last seen, refreshed only when it comes up short, as a log being recorded grows.
+        private long _length;
+
+        /// <summary>
+        /// Returns true if the file is a session log this version can read.
+        /// </summary>
+        public bool IsValid { get; private set; }
+
+        public SessionLogHeader Header { get; private set; }
+
+        /// <summary>
+        /// Number of complete records in the file.
+        /// </summary>
+        public long RecordCount { get; private set; }
+
+        public SessionLogReader(string path)
+        {
+            _stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite, BufferSize, FileOptions.SequentialScan);
+            _reader = new BinaryReader(_stream);
+            Header = SessionLogHeader.Read(_reader);
+            IsValid = Header != null;
+            _length = _stream.Length;
+            if (IsValid) RecordCount = (_length - Header.Size) / Header.RecordSize;
+        }
+
+        /// <summary>
+        /// Position the reader on a record.
+        /// </summary>
+        public void Seek(long recordIndex)
+        {
+            if (!IsValid) return;
+            _stream.Position = Header.Size + recordIndex * Header.RecordSize;
+        }
+
+        /// <summary>
+        /// Read the next record.
+        /// </summary>
+        /// <param name="timeStamp">Timestamp of the packet.</param>
+        /// <param name="payload">Receives the stream data, must hold at least Header.Layout.PayloadSize bytes.</param>
+        /// <returns>False at the end of the log.</returns>
+        public bool ReadRecord(out uint timeStamp, byte[] payload)
+        {
+            timeStamp = 0;
+            if (!IsValid || Remaining(Header.RecordSize) < Header.RecordSize) return false;
+            timeStamp = _reader.ReadUInt32();
+            var read = 0;
+            while (read < Header.Layout.PayloadSize)
+            {
+                var n = _stream.Read(payload, read, Header.Layout.PayloadSize - read);
+                if (n == 0) return false;
+                read += n;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Read as many whole records as fit into buffer.
+        /// </summary>
+        /// <returns>Number of records read, 0 at the end of the log.</returns>
+        public int ReadRecords(byte[] buffer)
+        {
+            if (!IsValid) return 0;
+            var capacity = buffer.Length / Header.RecordSize;
+            var wanted = (int)Math.Min(capacity, Remaining((long)capacity * Header.RecordSize) / Header.RecordSize);
+            var bytes = wanted * Header.RecordSize;
+            var read = 0;
+            while (read < bytes)
+            {
+                var n = _stream.Read(buffer, read, bytes - read);
+                if (n == 0) break;
+                read += n;
+            }
+            return read / Header.RecordSize;
+        }
+
+        /// <summary>
+        /// Bytes left after the position, from the cached length unless fewer than wanted.
+        /// </summary>
+        private long Remaining(long wanted)
+        {
+            var remaining = _length - _stream.Position;
+            if (remaining >= wanted) return remaining;
+            _length = _stream.Length;
+            return _length - _stream.Position;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            _reader.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Appends stream packets of one sensor to a session log file.
+    /// </summary>
+    public class SessionLogWriter : IDisposable
+    {
+        private const int BufferSize = 1 << 20;
+
+        private bool _isDisposed;
+
+        private readonly FileStream _stream;
+        private readonly BinaryWriter _writer;
+
+        public SessionLogHeader Header { get; private set; }
+
+        /// <summary>
+        /// Number of records written so far.
+        /// </summary>
+        public long RecordCount { get; private set; }
+
+        /// <summary>
+        /// Create a new session log, overwriting any existing file.
+        /// </summary>
+        public SessionLogWriter(string path, SessionLogHeader header)
+        {
+            Header = header;
+            _stream = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.Read, BufferSize, FileOptions.SequentialScan);
+            _writer = new BinaryWriter(_stream);
+            header.Write(_writer);
+        }
+
+        /// <summary>
+        /// Append one stream packet.
+        /// </summary>
+        /// <param name="timeStamp">Timestamp of the packet.</param>
+        /// <param name="payload">Buffer holding the packet's stream data.</param>
+        /// <param name="offset">Offset of the packet within payload.</param>
+        public void WriteRecord(uint timeStamp, byte[] payload, int offset)
+        {
+            _writer.Write(timeStamp);
+            _writer.Write(payload, offset, Header.Layout.PayloadSize);
+            RecordCount++;
+        }
+
+        /// <summary>
+        /// Append already formatted records (timestamp followed by payload) in one write.
+        /// </summary>
+        /// <param name="records">Buffer of back to back records.</param>
+        /// <param name="offset">Offset of the first record.</param>
+        /// <param name="count">Number of records.</param>
+        public void WriteRecords(byte[] records, int offset, int count)
+        {
+            _writer.Write(records, offset, count * Header.RecordSize);
+            RecordCount += count;
+        }
+
+        public void Flush()
+        {
+            _writer.Flush();
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            _writer.Flush();
+            _writer.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
@@ -0,0 +1,421 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Encodes blocks of session log records (uint TimeStamp followed by the payload) column by column.
+    /// 
+    /// Block body, in order:
+    ///     TimeStamps: first value, then zigzag varint delta of deltas.
+    ///     Each slot, in layout order:
+    ///         Byte valued slots: runs of (value, varint length).
+    ///         Orientation quaternions, when lossy: 2 bit index of the dropped (largest) component per record,
+    ///             then the three other components quantized, one zigzag varint delta column each.
+    ///         Other floats, one column per value with a mode byte:
+    ///             Xor:       nibble per value giving how many low bytes of (bits ^ previous bits) follow.
+    ///             Delta:     zigzag varint of (bits - previous bits), smaller than Xor for slowly changing values.
+    ///             Quantized: zigzag varint delta of round(value / ComponentResolution), for columns whose values
+    ///                        are all finite and within int.MaxValue / 2 steps.
+    /// Each column is gathered into an int array first, so every loop is a tight pass over one array.
+    /// </summary>
+    internal class StreamLogCodec
+    {
+        public const double SmallestThreeRange = 0.70710678118654752;
+
+        private const byte XorMode = 0;
+        private const byte DeltaMode = 1;
+        private const byte QuantizedMode = 2;
+
+        private readonly StreamSlotLayout _layout;
+        private readonly int _recordSize;
+        private readonly float _resolution;
+        private readonly double _quaternionStep;
+        private readonly int _quaternionMax;
+
+        private readonly int[] _column;
+        private readonly int[] _a;
+        private readonly int[] _b;
+        private readonly int[] _c;
+        private readonly byte[] _dropped;
+        private readonly double[] _components = new double[4];
+
+        public StreamLogCodec(StreamSlotLayout layout, StreamLogCodecOptions options)
+        {
+            _layout = layout;
+            _recordSize = 4 + layout.PayloadSize;
+            _resolution = options.ComponentResolution;
+
+            var bits = options.QuaternionBits;
+            if (bits > 0)
+            {
+                _quaternionMax = (1 << bits) - 1;
+                _quaternionStep = 2 * SmallestThreeRange / _quaternionMax;
+            }
+
+            var size = options.RecordsPerBlock;
+            _column = new int[size];
+            _a = new int[size];
+            _b = new int[size];
+            _c = new int[size];
+            _dropped = new byte[size];
+        }
+
+        private bool IsSmallestThree(StreamCommandEnum command)
+        {
+            return _quaternionMax > 0
+                   && (command == StreamCommandEnum.TaredOrientationAsQuaternion
+                       || command == StreamCommandEnum.UntaredOrientationAsQuaternion);
+        }
+
+        /// <summary>
+        /// Append the encoded block to output.
+        /// </summary>
+        public void Encode(byte[] records, int offset, int count, CodecBuffer output)
+        {
+            Gather(records, offset, count);
+            EncodeTimeStamps(count, output);
+
+            for (var slot = 0; slot < _layout.Slots.Length; slot++)
+            {
+                var command = _layout.Slots[slot];
+                var slotOffset = offset + 4 + _layout.OffsetOfSlot(slot);
+                if (StreamSlotLayout.IsByteValued(command))
+                {
+                    EncodeBytes(records, slotOffset, count, output);
+                }
+                else if (IsSmallestThree(command))
+                {
+                    EncodeQuaternions(records, slotOffset, count, output);
+                }
+                else
+                {
+                    for (var value = 0; value < StreamSlotLayout.ValueCount(command); value++)
+                    {
+                        Gather(records, slotOffset + value * 4, count);
+                        EncodeFloats(count, output);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Decode a block into back to back records.
+        /// </summary>
+        public void Decode(CodecBuffer input, int count, byte[] records, int offset)
+        {
+            DecodeTimeStamps(input, count);
+            Scatter(records, offset, count);
+
+            for (var slot = 0; slot < _layout.Slots.Length; slot++)
+            {
+                var command = _layout.Slots[slot];
+                var slotOffset = offset + 4 + _layout.OffsetOfSlot(slot);
+                if (StreamSlotLayout.IsByteValued(command))
+                {
+                    DecodeBytes(input, records, slotOffset, count);
+                }
+                else if (IsSmallestThree(command))
+                {
+                    DecodeQuaternions(input, records, slotOffset, count);
+                }
+                else
+                {
+                    for (var value = 0; value < StreamSlotLayout.ValueCount(command); value++)
+                    {
+                        DecodeFloats(input, count);
+                        Scatter(records, slotOffset + value * 4, count);
+                    }
+                }
+            }
+        }
+
+        private void Gather(byte[] records, int offset, int count)
+        {
+            var column = _column;
+            for (int i = 0, position = offset; i < count; i++, position += _recordSize)
+            {
+                column[i] = FloatBits.ReadInt32(records, position);
+            }
+        }
+
+        private void Scatter(byte[] records, int offset, int count)
+        {
+            var column = _column;
+            for (int i = 0, position = offset; i < count; i++, position += _recordSize)
+            {
+                FloatBits.WriteInt32(records, position, column[i]);
+            }
+        }
+
+        private void EncodeTimeStamps(int count, CodecBuffer output)
+        {
+            var column = _column;
+            output.Ensure(5 * count);
+            output.WriteVarUInt((uint)column[0]);
+            var previousDelta = 0;
+            for (var i = 1; i < count; i++)
+            {
+                var delta = column[i] - column[i - 1];
+                output.WriteVarUInt(CodecBuffer.ZigZag(delta - previousDelta));
+                previousDelta = delta;
+            }
+        }
+
+        private void DecodeTimeStamps(CodecBuffer input, int count)
+        {
+            var column = _column;
+            column[0] = (int)input.ReadVarUInt();
+            var delta = 0;
+            for (var i = 1; i < count; i++)
+            {
+                delta += CodecBuffer.UnZigZag(input.ReadVarUInt());
+                column[i] = column[i - 1] + delta;
+            }
+        }
+
+        private void EncodeBytes(byte[] records, int offset, int count, CodecBuffer output)
+        {
+            var position = offset;
+            var i = 0;
+            while (i < count)
+            {
+                var value = records[position];
+                var run = 1;
+                while (i + run < count && records[position + run * _recordSize] == value) run++;
+
+                output.Ensure(6);
+                output.Data[output.Position++] = value;
+                output.WriteVarUInt((uint)run);
+                i += run;
+                position += run * _recordSize;
+            }
+        }
+
+        private void DecodeBytes(CodecBuffer input, byte[] records, int offset, int count)
+        {
+            var position = offset;
+            var i = 0;
+            while (i < count)
+            {
+                var value = input.Data[input.Position++];
+                var run = (int)input.ReadVarUInt();
+                for (var j = 0; j < run; j++, position += _recordSize) records[position] = value;
+                i += run;
+            }
+        }
+
+        private void EncodeFloats(int count, CodecBuffer output)
+        {
+            var column = _column;
+            output.Ensure(1 + 5 * count);
+
+            if (_resolution > 0 && CanQuantize(count))
+            {
+                output.Data[output.Position++] = QuantizedMode;
+                var scale = 1.0 / _resolution;
+                var previous = 0;
+                for (var i = 0; i < count; i++)
+                {
+                    var quantized = (int)Math.Round(FloatBits.ToFloat(column[i]) * scale);
+                    output.WriteVarUInt(CodecBuffer.ZigZag(quantized - previous));
+                    previous = quantized;
+                }
+                return;
+            }
+
+            //Size both lossless predictors, then write the smaller.
+            int xorSize = (count + 1) / 2, deltaSize = 0;
+            for (var i = 0; i < count; i++)
+            {
+                var previous = i == 0 ? 0 : column[i - 1];
+                xorSize += SignificantBytes((uint)(column[i] ^ previous));
+                deltaSize += CodecBuffer.VarUIntSize(CodecBuffer.ZigZag(column[i] - previous));
+            }
+
+            if (deltaSize < xorSize)
+            {
+                output.Data[output.Position++] = DeltaMode;
+                var previous = 0;
+                for (var i = 0; i < count; i++)
+                {
+                    output.WriteVarUInt(CodecBuffer.ZigZag(column[i] - previous));
+                    previous = column[i];
+                }
+                return;
+            }
+
+            output.Data[output.Position++] = XorMode;
+            var headers = output.Position;
+            Array.Clear(output.Data, headers, (count + 1) / 2);
+            output.Position += (count + 1) / 2;
+            var last = 0;
+            for (var i = 0; i < count; i++)
+            {
+                var xor = (uint)(column[i] ^ last);
+                last = column[i];
+                var bytes = SignificantBytes(xor);
+                output.Data[headers + (i >> 1)] |= (byte)(bytes << ((i & 1) * 4));
+                for (var b = 0; b < bytes; b++, xor >>= 8) output.Data[output.Position++] = (byte)xor;
+            }
+        }
+
+        /// <summary>
+        /// True if every value of the column quantizes within half a step. NaN, infinities and values beyond
+        /// int.MaxValue / 2 steps are not, such a column is stored losslessly instead.
+        /// </summary>
+        private bool CanQuantize(int count)
+        {
+            var column = _column;
+            var limit = (int.MaxValue / 2) * (double)_resolution;
+            for (var i = 0; i < count; i++)
+            {
+                var value = FloatBits.ToFloat(column[i]);
+                //Written so NaN fails too.
+                if (!(Math.Abs(value) <= limit)) return false;
+            }
+            return true;
+        }
+
+        private void DecodeFloats(CodecBuffer input, int count)
+        {
+            var column = _column;
+            var data = input.Data;
+            var mode = data[input.Position++];
+
+            if (mode == QuantizedMode)
+            {
+                var quantized = 0;
+                for (var i = 0; i < count; i++)
+                {
+                    quantized += CodecBuffer.UnZigZag(input.ReadVarUInt());
+                    column[i] = FloatBits.ToInt32((float)(quantized * (double)_resolution));
+                }
+                return;
+            }
+
+            if (mode == DeltaMode)
+            {
+                var previous = 0;
+                for (var i = 0; i < count; i++)
+                {
+                    previous += CodecBuffer.UnZigZag(input.ReadVarUInt());
+                    column[i] = previous;
+                }
+                return;
+            }
+
+            var headers = input.Position;
+            input.Position += (count + 1) / 2;
+            var last = 0;
+            for (var i = 0; i < count; i++)
+            {
+                var bytes = (data[headers + (i >> 1)] >> ((i & 1) * 4)) & 0xf;
+                var xor = 0;
+                for (var b = 0; b < bytes; b++) xor |= data[input.Position++] << (b * 8);
+                last ^= xor;
+                column[i] = last;
+            }
+        }
+
+        private static int SignificantBytes(uint value)
+        {
+            return value == 0 ? 0 : value < 0x100 ? 1 : value < 0x10000 ? 2 : value < 0x1000000 ? 3 : 4;
+        }
+
+        private void EncodeQuaternions(byte[] records, int offset, int count, CodecBuffer output)
+        {
+            var components = _components;
+            for (int i = 0, position = offset; i < count; i++, position += _recordSize)
+            {
+                double norm = 0;
+                var largest = 0;
+                for (var k = 0; k < 4; k++)
+                {
+                    components[k] = BitConverter.ToSingle(records, position + k * 4);
+                    norm += components[k] * components[k];
+                    if (Math.Abs(components[k]) > Math.Abs(components[largest])) largest = k;
+                }
+
+                //q and -q are the same rotation, keep the dropped component positive so its sign need not be stored.
+                var scale = norm > 0 ? 1 / Math.Sqrt(norm) : 0;
+                if (components[largest] < 0) scale = -scale;
+
+                _dropped[i] = (byte)largest;
+                var stored = 0;
+                for (var k = 0; k < 4; k++)
+                {
+                    if (k == largest) continue;
+                    var quantized = (int)Math.Round((components[k] * scale + SmallestThreeRange) / _quaternionStep);
+                    quantized = Math.Max(0, Math.Min(_quaternionMax, quantized));
+                    if (stored == 0) _a[i] = quantized;
+                    else if (stored == 1) _b[i] = quantized;
+                    else _c[i] = quantized;
+                    stored++;
+                }
+            }
+
+            output.Ensure((count + 3) / 4 + 15 * count);
+            var indices = output.Position;
+            Array.Clear(output.Data, indices, (count + 3) / 4);
+            for (var i = 0; i < count; i++) output.Data[indices + (i >> 2)] |= (byte)(_dropped[i] << ((i & 3) * 2));
+            output.Position += (count + 3) / 4;
+
+            EncodeDeltas(_a, count, output);
+            EncodeDeltas(_b, count, output);
+            EncodeDeltas(_c, count, output);
+        }
+
+        private void DecodeQuaternions(CodecBuffer input, byte[] records, int offset, int count)
+        {
+            var indices = input.Position;
+            input.Position += (count + 3) / 4;
+            DecodeDeltas(input, _a, count);
+            DecodeDeltas(input, _b, count);
+            DecodeDeltas(input, _c, count);
+
+            var components = _components;
+            for (int i = 0, position = offset; i < count; i++, position += _recordSize)
+            {
+                var largest = (input.Data[indices + (i >> 2)] >> ((i & 3) * 2)) & 3;
+                var stored = 0;
+                double sum = 0;
+                for (var k = 0; k < 4; k++)
+                {
+                    if (k == largest) continue;
+                    var quantized = stored == 0 ? _a[i] : stored == 1 ? _b[i] : _c[i];
+                    components[k] = quantized * _quaternionStep - SmallestThreeRange;
+                    sum += components[k] * components[k];
+                    stored++;
+                }
+                components[largest] = Math.Sqrt(Math.Max(0, 1 - sum));
+                for (var k = 0; k < 4; k++) FloatBits.WriteInt32(records, position + k * 4, FloatBits.ToInt32((float)components[k]));
+            }
+        }
+
+        private static void EncodeDeltas(int[] column, int count, CodecBuffer output)
+        {
+            var previous = 0;
+            for (var i = 0; i < count; i++)
+            {
+                output.WriteVarUInt(CodecBuffer.ZigZag(column[i] - previous));
+                previous = column[i];
+            }
+        }
+
+        private static void DecodeDeltas(CodecBuffer input, int[] column, int count)
+        {
+            var previous = 0;
+            for (var i = 0; i < count; i++)
+            {
+                previous += CodecBuffer.UnZigZag(input.ReadVarUInt());
+                column[i] = previous;
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Recording
+{
+    /// <summary>
+    /// Settings of the compressed session log codec. All zero error settings make the codec lossless.
+    /// </summary>
+    public class StreamLogCodecOptions
+    {
+        /// <summary>
+        /// Maximum absolute error of each component of an orientation quaternion.
+        /// 0 stores quaternions losslessly, otherwise they are stored as the smallest three components.
+        /// A decoded quaternion may be the negation of the recorded one (the same rotation).
+        /// </summary>
+        public float QuaternionErrorBound { get; set; }
+
+        /// <summary>
+        /// Quantization step of every other float value (gyro, accelerometer, compass...).
+        /// 0 stores them losslessly, otherwise the error is at most half the step. A block column holding NaN,
+        /// infinity or a value beyond int.MaxValue / 2 steps is stored losslessly.
+        /// </summary>
+        public float ComponentResolution { get; set; }
+
+        /// <summary>
+        /// Records per independently decodable block, the unit of seeking.
+        /// </summary>
+        public int RecordsPerBlock { get; set; }
+
+        public StreamLogCodecOptions()
+        {
+            RecordsPerBlock = 4096;
+        }
+
+        /// <summary>
+        /// Bits per stored quaternion component needed to meet QuaternionErrorBound, 0 when lossless.
+        /// </summary>
+        public int QuaternionBits
+        {
+            get
+            {
+                if (QuaternionErrorBound <= 0) return 0;
+                //The three stored components lie in +-1/sqrt(2). Rebuilding the largest one (>= 1/2) from them
+                //can triple their error, so they are quantized to a third of the bound.
+                var steps = 2 * StreamLogCodec.SmallestThreeRange / (2.0 * QuaternionErrorBound / 3);
+                return Math.Max(1, Math.Min(30, (int)Math.Ceiling(Math.Log(steps + 1, 2))));
+            }
+        }
+    }
+}
@@ -0,0 +1,350 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Recording;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Replay
+{
+    /// <summary>
+    /// A SensorDevice playing back a recorded session instead of talking to hardware.
+    /// 
+    /// A playback thread walks the records at the session's own pace divided by Speed (or as fast as possible),
+    /// updating what the getters return and dispatching each record to the started SensorStreams.
+    /// Playback starts on first use (a getter or a stream start) or on Play.
+    /// Getters only succeed for values the session recorded, e.g. GetQuaternion needs a TaredOrientationAsQuaternion slot.
+    /// Commands without a recorded equivalent (Tare, LED) are accepted and have no effect on the data.
+    /// The async commands and SensorConfigurator call the API directly and fail on a replay device (it has no DeviceId).
+    /// Streams are played through the callback path only, polled streams (SensorStream.StartPolled) do not start.
+    /// </summary>
+    public class ReplayDevice : SensorDevice
+    {
+        private const int ChunkRecords = 256;
+
+        private bool _isDisposed;
+
+        private readonly ISessionLogReader _log;
+        private readonly StreamSlotLayout _layout;
+
+        private readonly object _stateLock = new object();
+        private readonly byte[] _payload;
+        private SensorSample _sample;
+        private bool _hasSample;
+        private Color _ledColour;
+
+        private readonly object _streamLock = new object();
+        private StreamTarget[] _streams = new StreamTarget[0];
+
+        private readonly object _playLock = new object();
+        private Thread _thread;
+        private volatile bool _stopRequested;
+        private readonly ManualResetEventSlim _firstRecord = new ManualResetEventSlim(false);
+        private readonly TaskCompletionSource<bool> _completion = new TaskCompletionSource<bool>();
+
+        private long _recordsReplayed;
+        private long _maxLagMicroseconds;
+
+        /// <summary>
+        /// Playback speed, 1 is real time, double.PositiveInfinity is as fast as possible.
+        /// </summary>
+        public double Speed { get; private set; }
+
+        /// <summary>
+        /// Start over at the end of the session instead of completing.
+        /// </summary>
+        public bool Loop { get; private set; }
+
+        /// <summary>
+        /// The recorded layout, what the getters and streams can serve.
+        /// </summary>
+        public StreamSlotLayout Layout { get { return _layout; } }
+
+        public bool IsPlaying { get { return _thread != null && !Completion.IsCompleted; } }
+
+        /// <summary>
+        /// Completes when the session has been played to the end, or playback was stopped.
+        /// </summary>
+        public Task Completion { get { return _completion.Task; } }
+
+        public long RecordsReplayed { get { return Interlocked.Read(ref _recordsReplayed); } }
+
+        /// <summary>
+        /// Longest delay behind the schedule, i.e. how much consumers slowed down playback.
+        /// </summary>
+        public TimeSpan MaxLag { get { return TimeSpan.FromTicks(Interlocked.Read(ref _maxLagMicroseconds) * 10); } }
+
+        /// <param name="log">The session, owned and disposed by the device.</param>
+        /// <param name="name">Shown as the port name.</param>
+        /// <param name="speed">1 for real time, N for N times faster, double.PositiveInfinity for as fast as possible.</param>
+        /// <param name="loop">Restart at the end of the session.</param>
+        public ReplayDevice(ISessionLogReader log, string name, double speed, bool loop)
+            : base(new ComPort { PortName = "Replay", FriendlyName = name, SensorType = SensorTypeEnum.Unknown }, log.Header.SerialNumber)
+        {
+            if (speed <= 0) throw new ArgumentOutOfRangeException("speed");
+
+            _log = log;
+            _layout = log.Header.Layout;
+            _payload = new byte[Math.Max(1, _layout.PayloadSize)];
+            Speed = speed;
+            Loop = loop;
+        }
+
+        /// <summary>
+        /// Start playback, returns once the first record is available.
+        /// </summary>
+        public void Play()
+        {
+            lock (_playLock)
+            {
+                if (_isDisposed) return;
+                if (_thread == null)
+                {
+                    _thread = new Thread(PlaybackLoop) { IsBackground = true, Name = "Replay " + SerialNumber };
+                    _thread.Start();
+                }
+            }
+            _firstRecord.Wait();
+        }
+
+        /// <summary>
+        /// Stop playback, the device keeps serving the last record.
+        /// </summary>
+        public void Stop()
+        {
+            _stopRequested = true;
+            var thread = _thread;
+            if (thread != null && thread != Thread.CurrentThread) thread.Join();
+        }
+
+        public override bool GetQuaternion()
+        {
+            if (!Serve(StreamCommandEnum.TaredOrientationAsQuaternion)) return false;
+            lock (_stateLock)
+            {
+                Quaternion = _sample.Quaternion;
+                TimeStamp = _sample.TimeStamp;
+            }
+            return true;
+        }
+
+        public override bool GetEulerAngles()
+        {
+            if (!Serve(StreamCommandEnum.TaredOrientationAsEulerAngles)) return false;
+            var offset = _layout.OffsetOf(StreamCommandEnum.TaredOrientationAsEulerAngles);
+            lock (_stateLock)
+            {
+                var vector = StreamSlotLayout.ReadVector(_payload, offset);
+                Euler = new Euler { X = vector.X, Y = vector.Y, Z = vector.Z };
+                TimeStamp = _sample.TimeStamp;
+            }
+            return true;
+        }
+
+        public override bool GetNormalizedSensorData()
+        {
+            if (!Serve(StreamCommandEnum.AllNormalizedComponentSensorData)) return false;
+            lock (_stateLock)
+            {
+                Gyro = _sample.Gyro;
+                Accelerometer = _sample.Accelerometer;
+                Compass = _sample.Compass;
+                TimeStamp = _sample.TimeStamp;
+            }
+            return true;
+        }
+
+        public override bool GetButtonState()
+        {
+            if (!Serve(StreamCommandEnum.ButtonState)) return false;
+            lock (_stateLock)
+            {
+                ButtonState = _sample.Buttons;
+            }
+            return true;
+        }
+
+        public override void Tare()
+        {
+        }
+
+        public override void SetLedColour(Color color)
+        {
+            _ledColour = color;
+        }
+
+        public override Color GetLedColour()
+        {
+            return _ledColour;
+        }
+
+        private bool Serve(StreamCommandEnum command)
+        {
+            if (!IsConnected || _layout.OffsetOf(command) < 0) return false;
+            Play();
+            return _hasSample;
+        }
+
+        protected internal override bool StartStreaming(SensorStream stream, StreamDataCallback callback)
+        {
+            if (callback == null) return false;
+
+            var target = CreateTarget(stream, stream.Layout);
+            if (target == null) return false;
+
+            lock (_streamLock)
+            {
+                _streams = _streams.Concat(new[] { target }).ToArray();
+            }
+            Play();
+            return true;
+        }
+
+        protected internal override bool ChangeStreamingSlots(SensorStream stream, StreamSlotLayout layout, out uint timeStamp)
+        {
+            timeStamp = _sample.TimeStamp;
+            var target = CreateTarget(stream, layout);
+            if (target == null) return false;
+
+            lock (_streamLock)
+            {
+                _streams = _streams.Select(s => s.Stream == stream ? target : s).ToArray();
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Each streamed slot is copied from where the recording holds it, null if a slot was not recorded.
+        /// </summary>
+        private StreamTarget CreateTarget(SensorStream stream, StreamSlotLayout layout)
+        {
+            var target = new StreamTarget { Stream = stream, Layout = layout, Payload = new byte[Math.Max(1, layout.PayloadSize)] };
+            target.SourceOffsets = new int[layout.Slots.Length];
+            for (var slot = 0; slot < layout.Slots.Length; slot++)
+            {
+                target.SourceOffsets[slot] = _layout.OffsetOf(layout.Slots[slot]);
+                if (target.SourceOffsets[slot] < 0) return null;
+            }
+            return target;
+        }
+
+        protected internal override void StopStreaming(SensorStream stream)
+        {
+            lock (_streamLock)
+            {
+                _streams = _streams.Where(s => s.Stream != stream).ToArray();
+            }
+        }
+
+        private void PlaybackLoop()
+        {
+            try
+            {
+                var recordSize = _log.Header.RecordSize;
+                var buffer = new byte[ChunkRecords * recordSize];
+                var watch = Stopwatch.StartNew();
+                long elapsedMicroseconds = 0;
+                uint previous = 0;
+                var first = true;
+
+                while (!_stopRequested)
+                {
+                    var count = _log.ReadRecords(buffer);
+                    if (count == 0)
+                    {
+                        if (!Loop || _log.RecordCount == 0) break;
+                        _log.Seek(0);
+                        first = true;
+                        elapsedMicroseconds = 0;
+                        watch.Restart();
+                        continue;
+                    }
+
+                    for (var i = 0; i < count && !_stopRequested; i++)
+                    {
+                        var offset = i * recordSize;
+                        var timeStamp = BitConverter.ToUInt32(buffer, offset);
+                        if (!first) elapsedMicroseconds += SensorClock.ElapsedMicroseconds(previous, timeStamp);
+                        previous = timeStamp;
+                        first = false;
+
+                        WaitUntil(watch, elapsedMicroseconds);
+                        Deliver(buffer, offset + 4, timeStamp);
+                    }
+                }
+            }
+            finally
+            {
+                _firstRecord.Set();
+                _completion.TrySetResult(true);
+            }
+        }
+
+        private void WaitUntil(Stopwatch watch, long elapsedMicroseconds)
+        {
+            if (double.IsPositiveInfinity(Speed)) return;
+
+            var due = (long)(elapsedMicroseconds / Speed);
+            while (!_stopRequested)
+            {
+                var now = watch.ElapsedTicks * 1000000 / Stopwatch.Frequency;
+                var remaining = due - now;
+                if (remaining <= 0)
+                {
+                    if (-remaining > Interlocked.Read(ref _maxLagMicroseconds)) Interlocked.Exchange(ref _maxLagMicroseconds, -remaining);
+                    return;
+                }
+                //Sleep for the bulk of the wait, spin the last couple of milliseconds for accurate spacing.
+                if (remaining > 2000) Thread.Sleep((int)(remaining / 1000) - 1);
+                else Thread.Yield();
+            }
+        }
+
+        private void Deliver(byte[] records, int payloadOffset, uint timeStamp)
+        {
+            lock (_stateLock)
+            {
+                Buffer.BlockCopy(records, payloadOffset, _payload, 0, _layout.PayloadSize);
+                _layout.Decode(_payload, 0, timeStamp, ref _sample);
+                _hasSample = true;
+            }
+            Interlocked.Increment(ref _recordsReplayed);
+            _firstRecord.Set();
+
+            var streams = _streams;
+            for (var s = 0; s < streams.Length; s++)
+            {
+                var target = streams[s];
+                var layout = target.Layout;
+                for (var slot = 0; slot < layout.Slots.Length; slot++)
+                {
+                    Buffer.BlockCopy(records, payloadOffset + target.SourceOffsets[slot], target.Payload, layout.OffsetOfSlot(slot),
+                                     StreamSlotLayout.ByteSize(layout.Slots[slot]));
+                }
+                target.Stream.Dispatch(layout, target.Payload, timeStamp);
+            }
+        }
+
+        public override void Dispose()
+        {
+            if (_isDisposed) return;
+            _isDisposed = true;
+            Stop();
+            _log.Dispose();
+            IsConnected = false;
+            base.Dispose();
+        }
+
+        private class StreamTarget
+        {
+            public SensorStream Stream;
+            public StreamSlotLayout Layout;
+            public byte[] Payload;
+            public int[] SourceOffsets;
+        }
+    }
+}
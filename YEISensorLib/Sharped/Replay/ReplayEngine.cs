@@ -0,0 +1,71 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Recording;
+
+namespace YEISensorLib.Sharped.Replay
+{
+    /// <summary>
+    /// A set of recorded sessions to be played back as sensors, each on its own playback thread.
+    /// 
+    /// Set SensorDevices.Replay to an engine and GetFirstAvailable/GetDevices return replay devices,
+    /// so an application runs unchanged without hardware:
+    ///     SensorDevices.Replay = new ReplayEngine(double.PositiveInfinity, @"C:\Sessions\a.ysl", @"C:\Sessions\b.ysc");
+    /// </summary>
+    public class ReplayEngine
+    {
+        /// <summary>
+        /// Session log (.ysl) or compressed session log (.ysc) files, one device each.
+        /// </summary>
+        public string[] Sessions { get; private set; }
+
+        /// <summary>
+        /// Playback speed, 1 is real time, double.PositiveInfinity is as fast as possible.
+        /// </summary>
+        public double Speed { get; private set; }
+
+        /// <summary>
+        /// Start sessions over when they end.
+        /// </summary>
+        public bool Loop { get; set; }
+
+        public ReplayEngine(double speed, params string[] sessions)
+        {
+            if (speed <= 0) throw new ArgumentOutOfRangeException("speed");
+            Speed = speed;
+            Sessions = sessions;
+        }
+
+        /// <summary>
+        /// Open a device per session, skipping files that are not session logs.
+        /// Every call plays the sessions from the start on new devices. Ensure that you dispose of them.
+        /// </summary>
+        public List<SensorDevice> CreateDevices()
+        {
+            var result = new List<SensorDevice>();
+            foreach (var session in Sessions)
+            {
+                var log = OpenLog(session);
+                if (log != null) result.Add(new ReplayDevice(log, session, Speed, Loop));
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Open a plain or compressed session log, null if the file is neither.
+        /// </summary>
+        public static ISessionLogReader OpenLog(string path)
+        {
+            ISessionLogReader log = new SessionLogReader(path);
+            if (log.IsValid) return log;
+            log.Dispose();
+
+            log = new CompressedSessionLogReader(path);
+            if (log.IsValid) return log;
+            log.Dispose();
+            return null;
+        }
+    }
+}
@@ -4,9 +4,16 @@ using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
 using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Async;
+using YEISensorLib.Sharped.Streaming;
+using YEISensorLib.Sharped.Wireless;
 
 namespace YEISensorLib.Sharped
 {
+    /// <summary>
+    /// A sensor reached through the ThreeSpace API.
+    /// Getters, streaming and Dispose are virtual so other backends (see Sharped.Replay) can stand in for the hardware.
+    /// </summary>
     public class SensorDevice : IDisposable
     {
         private bool _isDisposed;
@@ -14,20 +21,35 @@ namespace YEISensorLib.Sharped
         private ComPort _port;
         private readonly uint _deviceId;
 
+        /// <summary>
+        /// Pending async commands, see SensorDeviceAsyncExtensions.
+        /// </summary>
+        internal readonly DeviceCommandQueue CommandQueue = new DeviceCommandQueue();
+
+        /// <summary>
+        /// The API device id (TSS_Device_Id), for calling ThreeSpaceInterop directly.
+        /// </summary>
+        public uint DeviceId { get { return _deviceId; } }
+
         /// <summary>
         /// Returns true if the sensor is connected.
         /// </summary>
-        public bool IsConnected { get; private set; }
+        public bool IsConnected { get; protected set; }
 
         /// <summary>
         /// A bool indicating the sensor device is actually a dongle.
         /// </summary>
-        public bool IsDongle { get; private set; }
+        public bool IsDongle { get; protected set; }
 
         /// <summary>
         /// The hex serial number of the sensor
         /// </summary>
-        public string SerialNumber { get; private set; }
+        public string SerialNumber { get; protected set; }
+
+        /// <summary>
+        /// The serial number of the sensor as reported by the device.
+        /// </summary>
+        public uint SerialNumberValue { get; protected set; }
 
         /// <summary>
         /// The type of connected sensor
@@ -44,13 +66,38 @@ namespace YEISensorLib.Sharped
         /// </summary>
         public string FriendlyPortName { get { return _port.FriendlyName; } }
 
+        /// <summary>
+        /// The logical id on the dongle of a sensor opened with FromDongle, otherwise -1.
+        /// </summary>
+        public int LogicalId { get; private set; }
+
         public Vector3F Gyro;
         public Vector3F Accelerometer;
         public Vector3F Compass;
         public Euler Euler;
         public Quaternion Quaternion;
+        public ButtonState ButtonState;
         public uint TimeStamp;
 
+        /// <summary>
+        /// The most recently read values of the sensor as a single sample.
+        /// </summary>
+        public SensorSample LatestSample
+        {
+            get
+            {
+                return new SensorSample
+                           {
+                               TimeStamp = TimeStamp,
+                               Quaternion = Quaternion,
+                               Gyro = Gyro,
+                               Accelerometer = Accelerometer,
+                               Compass = Compass,
+                               Buttons = ButtonState
+                           };
+            }
+        }
+
         /// <summary>
         /// Create a sensor using the provided ComPort.
         /// </summary>
@@ -58,6 +105,7 @@ namespace YEISensorLib.Sharped
         public SensorDevice(ComPort port)
         {
             _port = port;
+            LogicalId = -1;
             _deviceId = ThreeSpaceInterop.CreateDevice(port.PortName, TimeStampModeEnum.Sensor);
             IsConnected = _deviceId != Defines.NO_DEVICE_ID;
             if (IsConnected)
@@ -67,11 +115,57 @@ namespace YEISensorLib.Sharped
             }
         }
 
+        /// <summary>
+        /// Open the wireless sensor paired at a logical id of a dongle.
+        /// The API returns the same device id for every call on the same sensor, and Dispose closes it:
+        /// keep one SensorDevice per wireless sensor.
+        /// </summary>
+        /// <param name="dongle">The dongle.</param>
+        /// <param name="logicalId">The sensor's logical id on the dongle, 0-14.</param>
+        /// <returns>The sensor, or null if none answers at the id.</returns>
+        public static SensorDevice FromDongle(SensorDevice dongle, int logicalId)
+        {
+            if (logicalId < 0 || logicalId >= WirelessDongle.LogicalIdCount) throw new ArgumentOutOfRangeException("logicalId");
+            if (!dongle.IsConnected || !dongle.IsDongle) return null;
+
+            uint deviceId;
+            var result = ThreeSpaceInterop.GetSensorFromDongle(dongle.DeviceId, logicalId, out deviceId);
+            if (result != ResultEnum.NoError || deviceId == Defines.NO_DEVICE_ID) return null;
+
+            var port = dongle._port;
+            port.SensorType = SensorTypeEnum.Wireless;
+            return new SensorDevice(port, deviceId, logicalId);
+        }
+
+        private SensorDevice(ComPort port, uint deviceId, int logicalId)
+        {
+            _port = port;
+            _deviceId = deviceId;
+            IsConnected = true;
+            LogicalId = logicalId;
+            LoadSerialNumber();
+        }
+
+        /// <summary>
+        /// Create a sensor that is not backed by the API, it has no DeviceId.
+        /// </summary>
+        /// <param name="port">Describes the source of the data.</param>
+        /// <param name="serialNumber">The serial number the sensor reports.</param>
+        protected SensorDevice(ComPort port, uint serialNumber)
+        {
+            _port = port;
+            _deviceId = Defines.NO_DEVICE_ID;
+            LogicalId = -1;
+            IsConnected = true;
+            SerialNumberValue = serialNumber;
+            SerialNumber = serialNumber.ToString("X8");
+        }
+
         /// <summary>
         /// Returns the filtered tared quaternion direct from the sensor.
         /// </summary>
         /// <returns></returns>
-        public bool GetQuaternion()
+        public virtual bool GetQuaternion()
         {
             if (!IsConnected || IsDongle) return false;
             var result = ThreeSpaceInterop.GetTaredOrientationAsQuaternion(_deviceId, out Quaternion, out TimeStamp);
@@ -83,7 +177,7 @@ namespace YEISensorLib.Sharped
         /// Returns the filtered tared euler angles from the sensor.
         /// </summary>
         /// <returns></returns>
-        public bool GetEulerAngles()
+        public virtual bool GetEulerAngles()
         {
             if (!IsConnected || IsDongle) return false;
             var result = ThreeSpaceInterop.GetTaredOrientationAsEulerAngles(_deviceId, out Euler, out TimeStamp);
@@ -95,7 +189,7 @@ namespace YEISensorLib.Sharped
         /// Returns the filtered tared quaternion direct from the sensor.
         /// </summary>
         /// <returns></returns>
-        public bool GetNormalizedSensorData()
+        public virtual bool GetNormalizedSensorData()
         {
             if (!IsConnected || IsDongle) return false;
             var result = ThreeSpaceInterop.GetAllNormalizedComponentSensorData(_deviceId, out Gyro, out Accelerometer, out Compass, out TimeStamp);
@@ -103,10 +197,96 @@ namespace YEISensorLib.Sharped
             return result == ResultEnum.NoError;
         }
 
+        /// <summary>
+        /// Reads the state of the physical buttons into ButtonState.
+        /// </summary>
+        /// <returns></returns>
+        public virtual bool GetButtonState()
+        {
+            if (!IsConnected || IsDongle) return false;
+            byte buttons;
+            uint timeStamp;
+            var result = ThreeSpaceInterop.GetButtonState(_deviceId, out buttons, out timeStamp);
+            if (result != ResultEnum.NoError) return false;
+
+            ButtonState = ButtonState.FromBitfield(buttons, timeStamp);
+            return true;
+        }
+
+        /// <summary>
+        /// Choose the clock of the timestamps. Sensors open with their own clock (Sensor),
+        /// System stamps packets with the host performance counter on arrival, comparable to Stopwatch.
+        /// </summary>
+        public bool SetTimeStampMode(TimeStampModeEnum mode)
+        {
+            if (!IsConnected) return false;
+            return ThreeSpaceInterop.SetTimeStampMode(_deviceId, mode) == ResultEnum.NoError;
+        }
+
+        /// <summary>
+        /// Sets what drives the interrupt pin, for hosts wired to it.
+        /// </summary>
+        /// <param name="mode">0 disabled, 1 pulse, 2 level.</param>
+        /// <param name="pin">0 none, 1 TXD, 2 MISO.</param>
+        public bool SetInterruptType(byte mode, byte pin)
+        {
+            if (!IsConnected || IsDongle) return false;
+            uint timeStamp;
+            return ThreeSpaceInterop.SetInterruptType(_deviceId, mode, pin, out timeStamp) == ResultEnum.NoError;
+        }
+
+        /// <summary>
+        /// Reads and clears the interrupt status, true in raised if an interrupt happened since the last read.
+        /// </summary>
+        public bool GetInterruptStatus(out bool raised)
+        {
+            raised = false;
+            if (!IsConnected || IsDongle) return false;
+            byte status;
+            uint timeStamp;
+            if (ThreeSpaceInterop.GetInterruptStatus(_deviceId, out status, out timeStamp) != ResultEnum.NoError) return false;
+
+            raised = status != 0;
+            return true;
+        }
+
+        /// <summary>
+        /// Ends the data-logging session of a data-logging sensor.
+        /// </summary>
+        /// <returns></returns>
+        public bool EndDataLoggingSession()
+        {
+            if (!IsConnected || IsDongle) return false;
+            uint timeStamp;
+            return ThreeSpaceInterop.EndDataLoggingSession(_deviceId, out timeStamp) == ResultEnum.NoError;
+        }
+
+        /// <summary>
+        /// Exposes the SD card of a data-logging sensor to the host as a drive.
+        /// </summary>
+        /// <returns></returns>
+        public bool TurnOnMassStorage()
+        {
+            if (!IsConnected || IsDongle) return false;
+            uint timeStamp;
+            return ThreeSpaceInterop.TurnOnMassStorage(_deviceId, out timeStamp) == ResultEnum.NoError;
+        }
+
+        /// <summary>
+        /// Hands the SD card of a data-logging sensor back to the sensor.
+        /// </summary>
+        /// <returns></returns>
+        public bool TurnOffMassStorage()
+        {
+            if (!IsConnected || IsDongle) return false;
+            uint timeStamp;
+            return ThreeSpaceInterop.TurnOffMassStorage(_deviceId, out timeStamp) == ResultEnum.NoError;
+        }
+
         /// <summary>
         /// Tare the device to the current orientation
         /// </summary>
-        public void Tare()
+        public virtual void Tare()
         {
             uint timestamp;
             ThreeSpaceInterop.TareWithCurrentOrientation(_deviceId, out timestamp);
@@ -114,11 +294,11 @@ namespace YEISensorLib.Sharped
 
        
 
-        public void SetLedColour(Color color)
+        public virtual void SetLedColour(Color color)
         {
             var resultCode = ThreeSpaceInterop.SetLedColor(_deviceId, new [] {color.R,color.G,color.B}, 0);
         }
-        public Color GetLedColour()
+        public virtual Color GetLedColour()
         {
             uint ignored;
 
@@ -131,12 +311,69 @@ namespace YEISensorLib.Sharped
             return result;
         }
 
+        /// <summary>
+        /// Configure the streaming slots and timing of the sensor and start streaming to the callback.
+        /// </summary>
+        /// <returns>False if the sensor rejected the configuration.</returns>
+        protected internal virtual bool StartStreaming(SensorStream stream, StreamDataCallback callback)
+        {
+            uint timeStamp;
+            if (ThreeSpaceInterop.SetStreamingSlots(_deviceId, SensorStream.SlotBytes(stream.Layout), out timeStamp) != ResultEnum.NoError) return false;
+            if (ThreeSpaceInterop.SetStreamingTiming(_deviceId, stream.IntervalMicroseconds, Defines.INF_DURATION, 0, out timeStamp) != ResultEnum.NoError) return false;
+            if (ThreeSpaceInterop.SetNewDataCallBack(_deviceId, callback) != ResultEnum.NoError) return false;
+            if (ThreeSpaceInterop.StartStreaming(_deviceId, out timeStamp) != ResultEnum.NoError)
+            {
+                ThreeSpaceInterop.SetNewDataCallBack(_deviceId, null);
+                return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Change the slots of a running stream.
+        /// </summary>
+        /// <param name="stream">The stream.</param>
+        /// <param name="layout">The new slots.</param>
+        /// <param name="timeStamp">Timestamp of the sensor's answer, packets stamped from then on have the new slots.</param>
+        /// <returns>False if the sensor rejected the slots.</returns>
+        protected internal virtual bool ChangeStreamingSlots(SensorStream stream, StreamSlotLayout layout, out uint timeStamp)
+        {
+            return ThreeSpaceInterop.SetStreamingSlots(_deviceId, SensorStream.SlotBytes(layout), out timeStamp) == ResultEnum.NoError;
+        }
+
+        /// <summary>
+        /// Copy the last stream packet without waiting, for streams started without a callback.
+        /// </summary>
+        protected internal virtual ResultEnum ReadLastStreamData(SensorStream stream, byte[] buffer, out uint timeStamp)
+        {
+            return ThreeSpaceInterop.GetLastStreamData(_deviceId, buffer, (uint)stream.Layout.PayloadSize, out timeStamp);
+        }
+
+        /// <summary>
+        /// Wait up to timeout milliseconds for the next stream packet, for streams started without a callback.
+        /// </summary>
+        protected internal virtual ResultEnum ReadLatestStreamData(SensorStream stream, byte[] buffer, uint timeout, out uint timeStamp)
+        {
+            return ThreeSpaceInterop.GetLatestStreamData(_deviceId, buffer, (uint)stream.Layout.PayloadSize, timeout, out timeStamp);
+        }
+
+        /// <summary>
+        /// Stop streaming and unregister the callback.
+        /// </summary>
+        protected internal virtual void StopStreaming(SensorStream stream)
+        {
+            uint timeStamp;
+            ThreeSpaceInterop.StopStreaming(_deviceId, out timeStamp);
+            ThreeSpaceInterop.SetNewDataCallBack(_deviceId, null);
+        }
+
         private void LoadSerialNumber()
         {
-            var buffer = new byte[9];
+            uint serialNumber;
             uint timeStamp;
-            ThreeSpaceInterop.GetSerialNumber(_deviceId, buffer, out timeStamp);
-            SerialNumber = BitConverter.ToString(buffer);
+            ThreeSpaceInterop.GetSerialNumber(_deviceId, out serialNumber, out timeStamp);
+            SerialNumberValue = serialNumber;
+            SerialNumber = serialNumber.ToString("X8");
         }
 
 
@@ -147,7 +384,7 @@ namespace YEISensorLib.Sharped
             if(!_isDisposed) Dispose();
         }
 
-        public void Dispose()
+        public virtual void Dispose()
         {
             if (_isDisposed) return;
             if (IsConnected)
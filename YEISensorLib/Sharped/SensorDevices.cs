@@ -4,17 +4,31 @@ using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
 using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Replay;
 
 namespace YEISensorLib.Sharped
 {
     public class SensorDevices
     {
+        /// <summary>
+        /// When set, devices are played back from recorded sessions instead of opened through the API.
+        /// </summary>
+        public static ReplayEngine Replay { get; set; }
+
         /// <summary>
         /// Returns the first available sensor device
         /// </summary>
         /// <returns></returns>
         public static SensorDevice GetFirstAvailable()
         {
+            var replay = Replay;
+            if (replay != null)
+            {
+                var devices = replay.CreateDevices();
+                foreach (var extra in devices.Skip(1)) extra.Dispose();
+                return devices.FirstOrDefault();
+            }
+
             var port = ThreeSpaceInterop.GetComPort(0);
             if(port != null) return new SensorDevice((ComPort)port);
             return null;
@@ -27,6 +41,9 @@ namespace YEISensorLib.Sharped
         /// <returns>List of all connected threespace devices</returns>
         public static List<SensorDevice> GetDevices() //NOTE: I don't think this code works.  I think I botched handling their vector thing.
         {
+            var replay = Replay;
+            if (replay != null) return replay.CreateDevices();
+
             var ports = new List<ComPort>();
             var thisPort = ThreeSpaceInterop.GetComPort(0);
             uint index = 0;
@@ -0,0 +1,28 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped
+{
+    /// <summary>
+    /// A single reading of a sensor: orientation, component vectors and button state.
+    /// Blittable so it can be copied straight into shared memory or a record buffer.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SensorSample
+    {
+        /// <summary>
+        /// Timestamp of the data
+        /// </summary>
+        public uint TimeStamp;
+        public Quaternion Quaternion;
+        public Vector3F Gyro;
+        public Vector3F Accelerometer;
+        public Vector3F Compass;
+        public ButtonState Buttons;
+    }
+}
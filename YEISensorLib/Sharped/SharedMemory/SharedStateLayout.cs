@@ -0,0 +1,85 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.SharedMemory
+{
+    /// <summary>
+    /// Byte layout of the shared state region.
+    /// 
+    /// Header (one cache line):
+    ///     int Magic, int Version, int SlotCount, int HistoryLength, int SampleSize, int SlotStride
+    /// Then SlotCount slots of SlotStride bytes, each:
+    ///     long Sequence, uint SerialNumber, SensorSample Sample   (latest value)
+    ///     long HistoryCount                                       (records ever written to the ring)
+    ///     HistoryLength entries of { long Sequence, SensorSample Sample }
+    /// 
+    /// Every sequence is a seqlock: odd while the writer is mid-update, even when stable.
+    /// History entry sequences are 2 * recordNumber + 2 when stable so a reader can tell
+    /// whether the entry it read still belongs to the record it wanted.
+    /// </summary>
+    internal static class SharedStateLayout
+    {
+        public const int Magic = 0x53535459; //"YTSS"
+        public const int Version = 1;
+        public const int CacheLine = 64;
+        public const int HeaderSize = CacheLine;
+
+        public const int MagicOffset = 0;
+        public const int VersionOffset = 4;
+        public const int SlotCountOffset = 8;
+        public const int HistoryLengthOffset = 12;
+        public const int SampleSizeOffset = 16;
+        public const int SlotStrideOffset = 20;
+
+        public const int SlotSequenceOffset = 0;
+        public const int SlotSerialOffset = 8;
+        public const int SlotSampleOffset = 16;
+
+        public const int EntrySampleOffset = 8;
+
+        public static readonly int SampleSize = Marshal.SizeOf(typeof(SensorSample));
+
+        /// <summary>
+        /// Offset of the history counter within a slot, on its own cache line so
+        /// readers polling the latest value do not share a line with the ring head.
+        /// </summary>
+        public static int HistoryCountOffset
+        {
+            get { return AlignToCacheLine(SlotSampleOffset + SampleSize); }
+        }
+
+        public static int HistoryEntriesOffset
+        {
+            get { return HistoryCountOffset + 8; }
+        }
+
+        public static int EntryStride
+        {
+            get { return Align(8 + SampleSize, 8); }
+        }
+
+        public static int SlotStride(int historyLength)
+        {
+            return AlignToCacheLine(HistoryEntriesOffset + EntryStride * historyLength);
+        }
+
+        public static long Capacity(int slotCount, int historyLength)
+        {
+            return HeaderSize + (long)SlotStride(historyLength) * slotCount;
+        }
+
+        public static int AlignToCacheLine(int value)
+        {
+            return Align(value, CacheLine);
+        }
+
+        private static int Align(int value, int alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+}
@@ -0,0 +1,153 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.SharedMemory
+{
+    /// <summary>
+    /// Publishes the latest sample of each sensor into a named shared memory region
+    /// so other processes can read live state without owning the COM port.
+    /// 
+    /// Each slot is guarded by a seqlock, the writer never waits on readers.
+    /// A slot must only be written from one thread at a time (one acquisition thread per device).
+    /// </summary>
+    public class SharedStatePublisher : IDisposable
+    {
+        private bool _isDisposed;
+
+        private readonly MemoryMappedFile _file;
+        private readonly MemoryMappedViewAccessor _view;
+        private readonly int _slotStride;
+        private readonly long[] _sequences;
+        private readonly long[] _historyCounts;
+
+        /// <summary>
+        /// The name other processes use to attach with SharedStateReader.
+        /// </summary>
+        public string MapName { get; private set; }
+
+        /// <summary>
+        /// The number of sensor slots in the region.
+        /// </summary>
+        public int SlotCount { get; private set; }
+
+        /// <summary>
+        /// The number of samples kept in each slot's history ring (0 for no history).
+        /// </summary>
+        public int HistoryLength { get; private set; }
+
+        /// <summary>
+        /// Create (or take over) a named shared state region.
+        /// </summary>
+        /// <exception cref="InvalidOperationException">The region exists already and is smaller than this layout needs.</exception>
+        /// <param name="mapName">Name of the region, e.g. "Local\\YEISensorState".</param>
+        /// <param name="slotCount">Number of sensors that will be published.</param>
+        /// <param name="historyLength">Samples of history to keep per sensor, 0 to disable.</param>
+        public SharedStatePublisher(string mapName, int slotCount, int historyLength)
+        {
+            if (slotCount <= 0) throw new ArgumentOutOfRangeException("slotCount");
+            if (historyLength < 0) throw new ArgumentOutOfRangeException("historyLength");
+
+            MapName = mapName;
+            SlotCount = slotCount;
+            HistoryLength = historyLength;
+            _slotStride = SharedStateLayout.SlotStride(historyLength);
+            _sequences = new long[slotCount];
+            _historyCounts = new long[slotCount];
+
+            var capacity = SharedStateLayout.Capacity(slotCount, historyLength);
+            _file = MemoryMappedFile.CreateOrOpen(mapName, capacity);
+            //An existing region keeps its size, view all of it and check it fits.
+            _view = _file.CreateViewAccessor();
+            if (_view.Capacity < capacity)
+            {
+                var existing = _view.Capacity;
+                _view.Dispose();
+                _file.Dispose();
+                throw new InvalidOperationException(string.Format(
+                    "Shared state region \"{0}\" exists with {1} bytes, {2} slots with {3} samples of history need {4}. Close its other users or pick another name.",
+                    mapName, existing, slotCount, historyLength, capacity));
+            }
+
+            //Readers check the magic last, so write it after the rest of the header and clear any stale slots.
+            _view.Write(SharedStateLayout.MagicOffset, 0);
+            Thread.MemoryBarrier();
+            for (var slot = 0; slot < slotCount; slot++)
+            {
+                var slotOffset = SlotOffset(slot);
+                _view.Write(slotOffset + SharedStateLayout.SlotSequenceOffset, 0L);
+                _view.Write(slotOffset + SharedStateLayout.HistoryCountOffset, 0L);
+            }
+            _view.Write(SharedStateLayout.VersionOffset, SharedStateLayout.Version);
+            _view.Write(SharedStateLayout.SlotCountOffset, slotCount);
+            _view.Write(SharedStateLayout.HistoryLengthOffset, historyLength);
+            _view.Write(SharedStateLayout.SampleSizeOffset, SharedStateLayout.SampleSize);
+            _view.Write(SharedStateLayout.SlotStrideOffset, _slotStride);
+            Thread.MemoryBarrier();
+            _view.Write(SharedStateLayout.MagicOffset, SharedStateLayout.Magic);
+        }
+
+        /// <summary>
+        /// Publish the latest sample of a device into a slot.
+        /// </summary>
+        public void Publish(int slot, SensorDevice device)
+        {
+            var sample = device.LatestSample;
+            Publish(slot, device.SerialNumberValue, ref sample);
+        }
+
+        /// <summary>
+        /// Publish a sample into a slot, appending it to the slot's history ring if enabled.
+        /// </summary>
+        /// <param name="slot">Slot index, 0 to SlotCount - 1.</param>
+        /// <param name="serialNumber">Serial number of the sensor owning the slot.</param>
+        /// <param name="sample">The sample to publish.</param>
+        public void Publish(int slot, uint serialNumber, ref SensorSample sample)
+        {
+            if (_isDisposed) throw new ObjectDisposedException("SharedStatePublisher");
+            if (slot < 0 || slot >= SlotCount) throw new ArgumentOutOfRangeException("slot");
+
+            var slotOffset = SlotOffset(slot);
+            var sequence = _sequences[slot];
+
+            _view.Write(slotOffset + SharedStateLayout.SlotSequenceOffset, sequence + 1);
+            Thread.MemoryBarrier();
+            _view.Write(slotOffset + SharedStateLayout.SlotSerialOffset, serialNumber);
+            _view.Write(slotOffset + SharedStateLayout.SlotSampleOffset, ref sample);
+            Thread.MemoryBarrier();
+            _view.Write(slotOffset + SharedStateLayout.SlotSequenceOffset, sequence + 2);
+            _sequences[slot] = sequence + 2;
+
+            if (HistoryLength == 0) return;
+
+            var record = _historyCounts[slot];
+            var entryOffset = slotOffset + SharedStateLayout.HistoryEntriesOffset
+                              + (record % HistoryLength) * SharedStateLayout.EntryStride;
+
+            _view.Write(entryOffset, 2 * record + 1);
+            Thread.MemoryBarrier();
+            _view.Write(entryOffset + SharedStateLayout.EntrySampleOffset, ref sample);
+            Thread.MemoryBarrier();
+            _view.Write(entryOffset, 2 * record + 2);
+            _view.Write(slotOffset + SharedStateLayout.HistoryCountOffset, record + 1);
+            _historyCounts[slot] = record + 1;
+        }
+
+        private long SlotOffset(int slot)
+        {
+            return SharedStateLayout.HeaderSize + (long)_slotStride * slot;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            _view.Dispose();
+            _file.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.SharedMemory
+{
+    /// <summary>
+    /// Attaches to a region created by SharedStatePublisher and reads live sensor state.
+    /// Reads are plain memory reads against the mapped view, no system calls and no locks.
+    /// </summary>
+    public class SharedStateReader : IDisposable
+    {
+        private const int MaxReadAttempts = 64;
+
+        private bool _isDisposed;
+
+        private readonly MemoryMappedFile _file;
+        private readonly MemoryMappedViewAccessor _view;
+        private readonly int _slotStride;
+
+        /// <summary>
+        /// Returns true if the region was found and has a compatible layout.
+        /// </summary>
+        public bool IsAttached { get; private set; }
+
+        /// <summary>
+        /// The number of sensor slots in the region.
+        /// </summary>
+        public int SlotCount { get; private set; }
+
+        /// <summary>
+        /// The number of samples kept in each slot's history ring.
+        /// </summary>
+        public int HistoryLength { get; private set; }
+
+        /// <summary>
+        /// Attach to an existing shared state region.
+        /// Check IsAttached before reading.
+        /// </summary>
+        /// <param name="mapName">The name the publisher was created with.</param>
+        public SharedStateReader(string mapName)
+        {
+            try
+            {
+                _file = MemoryMappedFile.OpenExisting(mapName, MemoryMappedFileRights.Read);
+                _view = _file.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read);
+            }
+            catch (FileNotFoundException)
+            {
+                return;
+            }
+
+            if (_view.Capacity < SharedStateLayout.HeaderSize) return;
+            if (_view.ReadInt32(SharedStateLayout.MagicOffset) != SharedStateLayout.Magic) return;
+            Thread.MemoryBarrier();
+            if (_view.ReadInt32(SharedStateLayout.VersionOffset) != SharedStateLayout.Version) return;
+            if (_view.ReadInt32(SharedStateLayout.SampleSizeOffset) != SharedStateLayout.SampleSize) return;
+
+            SlotCount = _view.ReadInt32(SharedStateLayout.SlotCountOffset);
+            HistoryLength = _view.ReadInt32(SharedStateLayout.HistoryLengthOffset);
+            _slotStride = _view.ReadInt32(SharedStateLayout.SlotStrideOffset);
+            IsAttached = _slotStride == SharedStateLayout.SlotStride(HistoryLength)
+                         && _view.Capacity >= SharedStateLayout.Capacity(SlotCount, HistoryLength);
+        }
+
+        /// <summary>
+        /// Read the latest sample of a slot.
+        /// </summary>
+        /// <param name="slot">Slot index, 0 to SlotCount - 1.</param>
+        /// <param name="serialNumber">Serial number of the sensor owning the slot.</param>
+        /// <param name="sample">The latest sample.</param>
+        /// <param name="sequence">Increases every time the slot is published, compare to detect new data.</param>
+        /// <returns>False if the slot has never been written or the writer kept it busy for every attempt.</returns>
+        public bool TryRead(int slot, out uint serialNumber, out SensorSample sample, out long sequence)
+        {
+            serialNumber = 0;
+            sample = new SensorSample();
+            sequence = 0;
+            if (!IsAttached || _isDisposed || slot < 0 || slot >= SlotCount) return false;
+
+            var slotOffset = SlotOffset(slot);
+            for (var attempt = 0; attempt < MaxReadAttempts; attempt++)
+            {
+                var before = _view.ReadInt64(slotOffset + SharedStateLayout.SlotSequenceOffset);
+                if (before == 0) return false;
+                if ((before & 1) != 0) continue;
+                Thread.MemoryBarrier();
+                serialNumber = _view.ReadUInt32(slotOffset + SharedStateLayout.SlotSerialOffset);
+                _view.Read(slotOffset + SharedStateLayout.SlotSampleOffset, out sample);
+                Thread.MemoryBarrier();
+                var after = _view.ReadInt64(slotOffset + SharedStateLayout.SlotSequenceOffset);
+                if (before == after)
+                {
+                    sequence = before / 2;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Copy the most recent history of a slot into buffer, newest first.
+        /// </summary>
+        /// <returns>The number of samples written into buffer.</returns>
+        public int ReadHistory(int slot, SensorSample[] buffer)
+        {
+            if (!IsAttached || _isDisposed || slot < 0 || slot >= SlotCount || HistoryLength == 0) return 0;
+
+            var slotOffset = SlotOffset(slot);
+            var count = _view.ReadInt64(slotOffset + SharedStateLayout.HistoryCountOffset);
+            Thread.MemoryBarrier();
+            var wanted = (int)Math.Min(Math.Min(count, HistoryLength), buffer.Length);
+
+            for (var i = 0; i < wanted; i++)
+            {
+                var record = count - 1 - i;
+                var entryOffset = slotOffset + SharedStateLayout.HistoryEntriesOffset
+                                  + (record % HistoryLength) * SharedStateLayout.EntryStride;
+                var stable = 2 * record + 2;
+
+                if (_view.ReadInt64(entryOffset) != stable) return i;
+                Thread.MemoryBarrier();
+                _view.Read(entryOffset + SharedStateLayout.EntrySampleOffset, out buffer[i]);
+                Thread.MemoryBarrier();
+                //The writer lapped us, everything older is being overwritten too.
+                if (_view.ReadInt64(entryOffset) != stable) return i;
+            }
+            return wanted;
+        }
+
+        private long SlotOffset(int slot)
+        {
+            return SharedStateLayout.HeaderSize + (long)_slotStride * slot;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            if (_view != null) _view.Dispose();
+            if (_file != null) _file.Dispose();
+            IsAttached = false;
+            _isDisposed = true;
+        }
+    }
+}
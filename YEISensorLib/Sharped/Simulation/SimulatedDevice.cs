@@ -0,0 +1,379 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Simulation
+{
+    /// <summary>
+    /// An emulated sensor driven by a SimulatedFleet, for load tests of the streaming pipeline without hardware.
+    /// 
+    /// Started SensorStreams get packets at their own interval and layout, decoded and dispatched to their sinks
+    /// like packets from the API callback, with the jitter, loss and timeouts of the options.
+    /// Polled streams (SensorStream.StartPolled) keep the last packet for Poll and Wait to read, like the API does.
+    /// Values are synthetic. Packets are stamped with the fleet clock in microseconds when sent (like TSS_TIMESTAMP_SYSTEM
+    /// stamps them on arrival), so SimulatedFleet.NowMicroseconds - TimeStamp is the latency of a sample at any point of the pipeline.
+    /// Getters return synthetic values and fail like a timed out command during an injected timeout.
+    /// </summary>
+    public class SimulatedDevice : SensorDevice
+    {
+        /// <summary>
+        /// Interval used for streams asking for "as fast as possible" (interval 0).
+        /// </summary>
+        public const uint FastestIntervalMicroseconds = 1000;
+
+        private bool _isDisposed;
+
+        private readonly SimulatedFleet _fleet;
+        private readonly Random _random;
+        private readonly Random _commandRandom;
+
+        private readonly object _streamLock = new object();
+        private StreamTarget[] _streams = new StreamTarget[0];
+        private long _timeoutUntil;
+
+        private long _packetsSent;
+        private long _packetsLost;
+        private long _packetsTimedOut;
+        private long _timeouts;
+        private long _commandTimeouts;
+        private long _maxLagMicroseconds;
+
+        public SimulatedDeviceOptions Options { get; private set; }
+
+        /// <summary>
+        /// Packets dispatched to streams.
+        /// </summary>
+        public long PacketsSent { get { return Interlocked.Read(ref _packetsSent); } }
+
+        /// <summary>
+        /// Packets dropped by the injected loss.
+        /// </summary>
+        public long PacketsLost { get { return Interlocked.Read(ref _packetsLost); } }
+
+        /// <summary>
+        /// Packets not sent during injected timeouts.
+        /// </summary>
+        public long PacketsTimedOut { get { return Interlocked.Read(ref _packetsTimedOut); } }
+
+        public long Timeouts { get { return Interlocked.Read(ref _timeouts); } }
+
+        public long CommandTimeouts { get { return Interlocked.Read(ref _commandTimeouts); } }
+
+        /// <summary>
+        /// Longest delay of a packet behind its schedule, i.e. how far the fleet thread or the sinks fell behind.
+        /// </summary>
+        public TimeSpan MaxLag { get { return TimeSpan.FromTicks(Interlocked.Read(ref _maxLagMicroseconds) * 10); } }
+
+        internal SimulatedDevice(SimulatedFleet fleet, uint serialNumber, SimulatedDeviceOptions options)
+            : base(new ComPort { PortName = "Simulated", FriendlyName = "Simulated " + serialNumber.ToString("X8"), SensorType = SensorTypeEnum.Unknown }, serialNumber)
+        {
+            _fleet = fleet;
+            Options = options;
+            var seed = unchecked(options.Seed * 486187739 + (int)serialNumber * 16777619);
+            _random = new Random(seed);
+            _commandRandom = new Random(~seed);
+        }
+
+        /// <summary>
+        /// Zero the counters, e.g. after a warm up.
+        /// </summary>
+        public void ResetStatistics()
+        {
+            Interlocked.Exchange(ref _packetsSent, 0);
+            Interlocked.Exchange(ref _packetsLost, 0);
+            Interlocked.Exchange(ref _packetsTimedOut, 0);
+            Interlocked.Exchange(ref _timeouts, 0);
+            Interlocked.Exchange(ref _commandTimeouts, 0);
+            Interlocked.Exchange(ref _maxLagMicroseconds, 0);
+        }
+
+        public override bool GetQuaternion()
+        {
+            if (!Command()) return false;
+            var now = _fleet.NowMicroseconds;
+            var half = Phase(now) * 0.5;
+            Quaternion = new Quaternion { X = 0, Y = (float)Math.Sin(half), Z = 0, W = (float)Math.Cos(half) };
+            TimeStamp = (uint)now;
+            return true;
+        }
+
+        public override bool GetEulerAngles()
+        {
+            if (!Command()) return false;
+            var now = _fleet.NowMicroseconds;
+            Euler = new Euler { X = 0, Y = (float)(Phase(now) % (2 * Math.PI)), Z = 0 };
+            TimeStamp = (uint)now;
+            return true;
+        }
+
+        public override bool GetNormalizedSensorData()
+        {
+            if (!Command()) return false;
+            var now = _fleet.NowMicroseconds;
+            Gyro = new Vector3F { X = 0, Y = 1, Z = 0 };
+            Accelerometer = new Vector3F { X = 0, Y = -1, Z = 0 };
+            Compass = new Vector3F { X = (float)Math.Cos(Phase(now)), Y = 0, Z = (float)Math.Sin(Phase(now)) };
+            TimeStamp = (uint)now;
+            return true;
+        }
+
+        public override bool GetButtonState()
+        {
+            if (!Command()) return false;
+            ButtonState = ButtonState.FromBitfield(0, (uint)_fleet.NowMicroseconds);
+            return true;
+        }
+
+        public override void Tare()
+        {
+            Command();
+        }
+
+        public override void SetLedColour(Color color)
+        {
+            Command();
+        }
+
+        public override Color GetLedColour()
+        {
+            Command();
+            return new Color();
+        }
+
+        /// <summary>
+        /// A command round trip: fails after the command timeout during an injected timeout, or at TimeoutRate.
+        /// </summary>
+        private bool Command()
+        {
+            if (!IsConnected) return false;
+
+            bool timedOut;
+            lock (_commandRandom)
+            {
+                timedOut = _fleet.NowMicroseconds < Interlocked.Read(ref _timeoutUntil) || _commandRandom.NextDouble() < Options.TimeoutRate;
+            }
+            if (!timedOut) return true;
+
+            Interlocked.Increment(ref _commandTimeouts);
+            Thread.Sleep(Options.CommandTimeoutMilliseconds);
+            return false;
+        }
+
+        protected internal override bool StartStreaming(SensorStream stream, StreamDataCallback callback)
+        {
+            if (!IsConnected) return false;
+
+            var interval = stream.IntervalMicroseconds == 0 ? FastestIntervalMicroseconds : stream.IntervalMicroseconds;
+            var target = new StreamTarget
+                             {
+                                 Stream = stream,
+                                 Polled = callback == null,
+                                 Interval = interval,
+                                 Next = _fleet.NowMicroseconds + interval
+                             };
+            SetTargetLayout(target, stream.Layout);
+            target.Due = target.Next;
+
+            lock (_streamLock)
+            {
+                _streams = _streams.Concat(new[] { target }).ToArray();
+            }
+            return true;
+        }
+
+        protected internal override bool ChangeStreamingSlots(SensorStream stream, StreamSlotLayout layout, out uint timeStamp)
+        {
+            var target = _streams.FirstOrDefault(s => s.Stream == stream);
+            if (target != null) SetTargetLayout(target, layout);
+            //A packet stamped in this microsecond may have been filled with the old layout.
+            timeStamp = (uint)_fleet.NowMicroseconds + 1;
+            return true;
+        }
+
+        protected internal override void StopStreaming(SensorStream stream)
+        {
+            lock (_streamLock)
+            {
+                _streams = _streams.Where(s => s.Stream != stream).ToArray();
+            }
+        }
+
+        protected internal override ResultEnum ReadLastStreamData(SensorStream stream, byte[] buffer, out uint timeStamp)
+        {
+            timeStamp = 0;
+            var target = _streams.FirstOrDefault(s => s.Stream == stream);
+            if (target == null || !target.Polled) return ResultEnum.ErrorCommandFail;
+
+            lock (target)
+            {
+                if (target.LastSent == 0) return ResultEnum.ErrorReading;
+                return CopyLastPacket(target, buffer, out timeStamp);
+            }
+        }
+
+        protected internal override ResultEnum ReadLatestStreamData(SensorStream stream, byte[] buffer, uint timeout, out uint timeStamp)
+        {
+            timeStamp = 0;
+            var target = _streams.FirstOrDefault(s => s.Stream == stream);
+            if (target == null || !target.Polled) return ResultEnum.ErrorCommandFail;
+
+            lock (target)
+            {
+                var deadline = Environment.TickCount + (int)timeout;
+                while (target.LastSent == target.LastRead)
+                {
+                    var remaining = deadline - Environment.TickCount;
+                    if (remaining <= 0 || !Monitor.Wait(target, remaining)) return ResultEnum.ErrorTimeout;
+                }
+                return CopyLastPacket(target, buffer, out timeStamp);
+            }
+        }
+
+        private static ResultEnum CopyLastPacket(StreamTarget target, byte[] buffer, out uint timeStamp)
+        {
+            Buffer.BlockCopy(target.LastPacket, 0, buffer, 0, Math.Min(target.LastPacket.Length, buffer.Length));
+            timeStamp = target.LastTimeStamp;
+            target.LastRead = target.LastSent;
+            return ResultEnum.NoError;
+        }
+
+        private static void SetTargetLayout(StreamTarget target, StreamSlotLayout layout)
+        {
+            //Swapped as one object so the fleet thread never sees a layout with the wrong buffer.
+            target.Packet = new PacketBuffer { Layout = layout, Payload = new byte[Math.Max(1, layout.PayloadSize)] };
+        }
+
+        /// <summary>
+        /// Called by the fleet thread: send every packet due by now, and lower nextDue to this device's next packet.
+        /// </summary>
+        internal void Pump(long now, ref long nextDue)
+        {
+            var streams = _streams;
+            for (var s = 0; s < streams.Length; s++)
+            {
+                var target = streams[s];
+                while (target.Due <= now)
+                {
+                    Send(target, target.Due);
+
+                    target.Next += target.Interval;
+                    var jitter = Options.JitterMicroseconds;
+                    target.Due = jitter == 0 ? target.Next : Math.Max(target.Due, target.Next + _random.Next(-(int)jitter, (int)jitter + 1));
+                }
+                if (target.Due < nextDue) nextDue = target.Due;
+            }
+        }
+
+        private void Send(StreamTarget target, long due)
+        {
+            var timeStamp = _fleet.NowMicroseconds;
+            if (timeStamp < _timeoutUntil)
+            {
+                Interlocked.Increment(ref _packetsTimedOut);
+                return;
+            }
+            if (Options.TimeoutRate > 0 && _random.NextDouble() < Options.TimeoutRate)
+            {
+                Interlocked.Exchange(ref _timeoutUntil, timeStamp + Options.TimeoutMicroseconds);
+                Interlocked.Increment(ref _timeouts);
+                Interlocked.Increment(ref _packetsTimedOut);
+                return;
+            }
+            if (Options.LossRate > 0 && _random.NextDouble() < Options.LossRate)
+            {
+                Interlocked.Increment(ref _packetsLost);
+                return;
+            }
+
+            var lag = timeStamp - due;
+            if (lag > Interlocked.Read(ref _maxLagMicroseconds)) Interlocked.Exchange(ref _maxLagMicroseconds, lag);
+
+            var packet = target.Packet;
+            Fill(packet.Layout, packet.Payload, timeStamp);
+            Interlocked.Increment(ref _packetsSent);
+            if (!target.Polled)
+            {
+                target.Stream.Dispatch(packet.Layout, packet.Payload, (uint)timeStamp);
+                return;
+            }
+
+            lock (target)
+            {
+                if (target.LastPacket == null || target.LastPacket.Length < packet.Payload.Length) target.LastPacket = new byte[packet.Payload.Length];
+                Buffer.BlockCopy(packet.Payload, 0, target.LastPacket, 0, packet.Payload.Length);
+                target.LastTimeStamp = (uint)timeStamp;
+                target.LastSent++;
+                Monitor.PulseAll(target);
+            }
+        }
+
+        /// <summary>
+        /// Synthetic values: a slow rotation about Y, constant gravity and a gyro reading to match.
+        /// </summary>
+        private static void Fill(StreamSlotLayout layout, byte[] payload, long timeStamp)
+        {
+            var phase = Phase(timeStamp);
+            for (var slot = 0; slot < layout.Slots.Length; slot++)
+            {
+                var command = layout.Slots[slot];
+                var offset = layout.OffsetOfSlot(slot);
+                if (StreamSlotLayout.IsByteValued(command))
+                {
+                    payload[offset] = command == StreamCommandEnum.BatteryPercentRemaining ? (byte)100 : (byte)0;
+                    continue;
+                }
+
+                var count = StreamSlotLayout.ValueCount(command);
+                for (var i = 0; i < count; i++)
+                {
+                    FloatBits.WriteInt32(payload, offset + i * 4, FloatBits.ToInt32((float)Math.Sin(phase + i)));
+                }
+            }
+        }
+
+        private static double Phase(long microseconds)
+        {
+            return microseconds * 1e-6;
+        }
+
+        public override void Dispose()
+        {
+            if (_isDisposed) return;
+            _isDisposed = true;
+            lock (_streamLock)
+            {
+                _streams = new StreamTarget[0];
+            }
+            _fleet.Remove(this);
+            IsConnected = false;
+            base.Dispose();
+        }
+
+        private class StreamTarget
+        {
+            public SensorStream Stream;
+            public long Interval;
+            public long Next;
+            public long Due;
+            public volatile PacketBuffer Packet;
+
+            //Polled streams: the last packet sent, read under a lock on the target.
+            public bool Polled;
+            public byte[] LastPacket;
+            public uint LastTimeStamp;
+            public long LastSent;
+            public long LastRead;
+        }
+
+        private class PacketBuffer
+        {
+            public StreamSlotLayout Layout;
+            public byte[] Payload;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Simulation
+{
+    /// <summary>
+    /// Link faults a SimulatedDevice injects. Rate and slot layout come from the SensorStreams started on it.
+    /// </summary>
+    public class SimulatedDeviceOptions
+    {
+        /// <summary>
+        /// Each packet is sent up to this many microseconds early or late.
+        /// </summary>
+        public uint JitterMicroseconds { get; set; }
+
+        /// <summary>
+        /// Probability of losing a packet.
+        /// </summary>
+        public double LossRate { get; set; }
+
+        /// <summary>
+        /// Probability per packet of the link timing out (TSS_ERROR_TIMEOUT): no packets for TimeoutMicroseconds,
+        /// and commands during that time fail after CommandTimeoutMilliseconds.
+        /// </summary>
+        public double TimeoutRate { get; set; }
+
+        public uint TimeoutMicroseconds { get; set; }
+
+        public int CommandTimeoutMilliseconds { get; set; }
+
+        /// <summary>
+        /// Seed of the fault generator, runs with the same seed inject the same faults.
+        /// </summary>
+        public int Seed { get; set; }
+
+        public SimulatedDeviceOptions()
+        {
+            TimeoutMicroseconds = 200000;
+            CommandTimeoutMilliseconds = 50;
+        }
+    }
+}
@@ -0,0 +1,143 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Simulation
+{
+    /// <summary>
+    /// Drives any number of SimulatedDevices from a few threads, for scaling tests of the acquisition pipeline.
+    /// 
+    /// Devices are spread round robin over the fleet threads. Each thread sends every packet that is due, then
+    /// sleeps until the next one, or spins if it is closer than SpinThresholdMicroseconds. Sleeping sends packets
+    /// up to a scheduler tick late but leaves the CPU to the pipeline, spinning is precise but burns the threads.
+    /// Packets run through the sinks on the fleet thread, as they would on the API callback thread, so slow sinks
+    /// show up as device MaxLag and as BusyTime.
+    /// 
+    /// Usage:
+    ///     using (var fleet = new SimulatedFleet(4))
+    ///     {
+    ///         var device = fleet.CreateDevice(new SimulatedDeviceOptions { LossRate = 0.001 });
+    ///         var stream = new SensorStream(device, layout, 5000);
+    ///         stream.AddSink(...);
+    ///         stream.Start();
+    ///     }
+    /// </summary>
+    public class SimulatedFleet : IDisposable
+    {
+        private bool _isDisposed;
+
+        private readonly Stopwatch _clock = Stopwatch.StartNew();
+        private readonly double _microsecondsPerTick = 1000000.0 / Stopwatch.Frequency;
+        private readonly Thread[] _threads;
+        private readonly SimulatedDevice[][] _devicesByThread;
+        private readonly object _devicesLock = new object();
+        private volatile bool _stopRequested;
+        private int _nextThread;
+        private uint _nextSerialNumber = 0x50000000;
+        private long _busyTicks;
+
+        /// <summary>
+        /// Microseconds since the fleet was created, the clock of the devices' timestamps.
+        /// </summary>
+        public long NowMicroseconds { get { return (long)(_clock.ElapsedTicks * _microsecondsPerTick); } }
+
+        /// <summary>
+        /// Spin instead of sleeping when the next packet is due within this many microseconds, 0 never spins.
+        /// </summary>
+        public long SpinThresholdMicroseconds { get; set; }
+
+        /// <summary>
+        /// Time the fleet threads spent sending packets and running the sinks, the CPU cost of the pipeline.
+        /// </summary>
+        public TimeSpan BusyTime
+        {
+            get { return TimeSpan.FromTicks((long)(Interlocked.Read(ref _busyTicks) * _microsecondsPerTick * 10)); }
+        }
+
+        public IList<SimulatedDevice> Devices
+        {
+            get { return _devicesByThread.SelectMany(devices => devices).ToArray(); }
+        }
+
+        /// <param name="threads">Threads sending the packets of all devices.</param>
+        public SimulatedFleet(int threads)
+        {
+            if (threads <= 0) throw new ArgumentOutOfRangeException("threads");
+
+            _devicesByThread = new SimulatedDevice[threads][];
+            _threads = new Thread[threads];
+            for (var i = 0; i < threads; i++)
+            {
+                _devicesByThread[i] = new SimulatedDevice[0];
+                var index = i;
+                _threads[i] = new Thread(() => Run(index)) { IsBackground = true, Name = "Simulated fleet " + i };
+                _threads[i].Start();
+            }
+        }
+
+        public SimulatedDevice CreateDevice(SimulatedDeviceOptions options)
+        {
+            lock (_devicesLock)
+            {
+                var device = new SimulatedDevice(this, _nextSerialNumber++, options);
+                var thread = _nextThread++ % _threads.Length;
+                _devicesByThread[thread] = _devicesByThread[thread].Concat(new[] { device }).ToArray();
+                return device;
+            }
+        }
+
+        /// <summary>
+        /// Zero BusyTime and the counters of every device.
+        /// </summary>
+        public void ResetStatistics()
+        {
+            Interlocked.Exchange(ref _busyTicks, 0);
+            foreach (var device in Devices) device.ResetStatistics();
+        }
+
+        internal void Remove(SimulatedDevice device)
+        {
+            lock (_devicesLock)
+            {
+                for (var i = 0; i < _devicesByThread.Length; i++)
+                {
+                    _devicesByThread[i] = _devicesByThread[i].Where(d => d != device).ToArray();
+                }
+            }
+        }
+
+        private void Run(int index)
+        {
+            while (!_stopRequested)
+            {
+                var devices = Volatile.Read(ref _devicesByThread[index]);
+                var start = _clock.ElapsedTicks;
+                var now = (long)(start * _microsecondsPerTick);
+                var nextDue = long.MaxValue;
+                for (var d = 0; d < devices.Length; d++)
+                {
+                    devices[d].Pump(now, ref nextDue);
+                }
+                var end = _clock.ElapsedTicks;
+                Interlocked.Add(ref _busyTicks, end - start);
+
+                var wait = nextDue - (long)(end * _microsecondsPerTick);
+                if (wait > SpinThresholdMicroseconds) Thread.Sleep(1);
+                else if (wait > 0) Thread.SpinWait(20);
+            }
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            _isDisposed = true;
+            _stopRequested = true;
+            foreach (var thread in _threads) thread.Join();
+            foreach (var device in Devices) device.Dispose();
+        }
+    }
+}
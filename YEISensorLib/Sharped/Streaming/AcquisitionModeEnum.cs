@@ -0,0 +1,25 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// How a LowLatencyAcquisition reads its streams.
+    /// </summary>
+    public enum AcquisitionModeEnum
+    {
+        /// <summary>
+        /// One thread per stream blocking in tss_getLatestStreamData, woken by the API when a packet arrives.
+        /// </summary>
+        Blocking,
+
+        /// <summary>
+        /// Threads spinning on tss_getLastStreamData over their streams, parking only after SpinMicroseconds without data.
+        /// Only the last packet is read, a thread that falls behind the stream skips packets.
+        /// </summary>
+        BusyPoll,
+    }
+}
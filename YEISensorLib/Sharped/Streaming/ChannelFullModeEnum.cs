@@ -0,0 +1,18 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// What a bounded channel does with a sample when the consumer has fallen behind.
+    /// A sensor cannot be slowed down, so the channel sheds samples instead of blocking the acquisition thread.
+    /// </summary>
+    public enum ChannelFullModeEnum
+    {
+        DropOldest, //Keep the freshest data, for live consumers
+        DropNewest  //Keep what is queued, for consumers that need contiguous runs
+    }
+}
@@ -0,0 +1,47 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Reinterprets a float as its IEEE 754 bits without unsafe code or allocation.
+    /// </summary>
+    [StructLayout(LayoutKind.Explicit)]
+    internal struct FloatBits
+    {
+        [FieldOffset(0)]
+        public float Float;
+        [FieldOffset(0)]
+        public int Int32;
+
+        public static int ToInt32(float value)
+        {
+            return new FloatBits { Float = value }.Int32;
+        }
+
+        public static float ToFloat(int bits)
+        {
+            return new FloatBits { Int32 = bits }.Float;
+        }
+
+        /// <summary>
+        /// Writes a little endian 32 bit value, the byte order stream payloads use on the host.
+        /// </summary>
+        public static void WriteInt32(byte[] buffer, int offset, int value)
+        {
+            buffer[offset] = (byte)value;
+            buffer[offset + 1] = (byte)(value >> 8);
+            buffer[offset + 2] = (byte)(value >> 16);
+            buffer[offset + 3] = (byte)(value >> 24);
+        }
+
+        public static int ReadInt32(byte[] buffer, int offset)
+        {
+            return buffer[offset] | (buffer[offset + 1] << 8) | (buffer[offset + 2] << 16) | (buffer[offset + 3] << 24);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Receives every decoded packet of a SensorStream.
+    /// Called on the acquisition thread, implementations must be quick and must not block.
+    /// </summary>
+    public interface IStreamSink
+    {
+        /// <summary>
+        /// A packet arrived.
+        /// </summary>
+        /// <param name="stream">The stream the packet came from.</param>
+        /// <param name="sample">The packet decoded on top of the previous sample, fields not streamed keep their last value.</param>
+        /// <param name="payload">The raw packet, laid out as stream.Layout. Only valid during the call.</param>
+        void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload);
+    }
+}
@@ -0,0 +1,222 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.Sharped.Analytics;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Opt-in low latency acquisition: streams are read without the API callback by dedicated threads,
+    /// optionally pinned to cores, and their sinks run on those threads.
+    /// 
+    /// BusyPoll spins on tss_getLastStreamData, so a packet reaches the sinks within one poll of its arrival instead of
+    /// after a scheduler wake up, at the cost of a core per thread. Blocking is the default style path, for comparison.
+    /// Latency records, per dispatched packet, Clock minus the packet timestamp. It is meaningful when both run on the
+    /// same clock: sensors switched to SetTimeStampMode(TimeStampModeEnum.System) with the default Stopwatch clock, or simulated devices with
+    /// SimulatedFleet.NowMicroseconds.
+    /// 
+    /// Usage:
+    ///     var acquisition = new LowLatencyAcquisition(new LowLatencyAcquisitionOptions { Cores = new[] { 2, 3 }, Threads = 2 }, streams);
+    ///     acquisition.Start();
+    ///     ...
+    ///     acquisition.Stop();
+    ///     Console.WriteLine(acquisition.Latency.Percentile(0.99));
+    /// </summary>
+    public class LowLatencyAcquisition : IDisposable
+    {
+        private bool _isDisposed;
+
+        private readonly SensorStream[] _streams;
+        private readonly LatencySink _latency;
+        private Thread[] _threads = new Thread[0];
+        private volatile bool _stopRequested;
+        private int _pinnedThreads;
+        private long _parks;
+
+        public LowLatencyAcquisitionOptions Options { get; private set; }
+
+        /// <summary>
+        /// The mode the threads run in, Options.Mode unless busy polling would leave no core to the packet producers.
+        /// </summary>
+        public AcquisitionModeEnum Mode { get; private set; }
+
+        public IList<SensorStream> Streams { get { return _streams; } }
+
+        /// <summary>
+        /// Microseconds from packet timestamp to dispatch.
+        /// </summary>
+        public LatencyHistogram Latency { get; private set; }
+
+        /// <summary>
+        /// Clock the latency is measured with, in microseconds. Defaults to the Stopwatch.
+        /// </summary>
+        public Func<long> Clock { get; set; }
+
+        /// <summary>
+        /// Threads that could be pinned to their core.
+        /// </summary>
+        public int PinnedThreads { get { return Volatile.Read(ref _pinnedThreads); } }
+
+        /// <summary>
+        /// Times a busy poll thread ran out of spinning and slept.
+        /// </summary>
+        public long Parks { get { return Interlocked.Read(ref _parks); } }
+
+        public bool IsRunning { get { return _threads.Length > 0; } }
+
+        public LowLatencyAcquisition(LowLatencyAcquisitionOptions options, params SensorStream[] streams)
+        {
+            if (options.Threads <= 0) throw new ArgumentOutOfRangeException("options", "Threads must be positive.");
+
+            Options = options;
+            Mode = options.Mode;
+            _streams = streams;
+            Latency = new LatencyHistogram();
+            var frequency = (double)Stopwatch.Frequency;
+            Clock = () => (long)(Stopwatch.GetTimestamp() * 1000000.0 / frequency);
+            _latency = new LatencySink(this);
+        }
+
+        /// <summary>
+        /// Start the streams polled and the acquisition threads.
+        /// </summary>
+        /// <returns>False if a stream did not start, the ones that did are stopped again.</returns>
+        public bool Start()
+        {
+            if (IsRunning) return true;
+
+            foreach (var stream in _streams)
+            {
+                if (stream.StartPolled()) continue;
+
+                foreach (var started in _streams.TakeWhile(s => s != stream)) started.Stop();
+                return false;
+            }
+            foreach (var stream in _streams) stream.AddSink(_latency);
+
+            _stopRequested = false;
+            _pinnedThreads = 0;
+            var threads = new List<Thread>();
+            Mode = Environment.ProcessorCount < 2 ? AcquisitionModeEnum.Blocking : Options.Mode;
+            if (Mode == AcquisitionModeEnum.Blocking)
+            {
+                for (var t = 0; t < _streams.Length; t++)
+                {
+                    var index = t;
+                    threads.Add(new Thread(() => RunBlocking(index, _streams[index])));
+                }
+            }
+            else
+            {
+                //Leave a core to the threads filling the stream buffers.
+                var count = Math.Min(Math.Min(Options.Threads, Environment.ProcessorCount - 1), Math.Max(1, _streams.Length));
+                for (var t = 0; t < count; t++)
+                {
+                    var index = t;
+                    var own = _streams.Where((s, i) => i % count == index).ToArray();
+                    threads.Add(new Thread(() => RunBusyPoll(index, own)));
+                }
+            }
+
+            for (var t = 0; t < threads.Count; t++)
+            {
+                var thread = threads[t];
+                thread.IsBackground = true;
+                thread.Priority = Options.Priority;
+                thread.Name = "Acquisition " + t;
+            }
+            _threads = threads.ToArray();
+            foreach (var thread in _threads) thread.Start();
+            return true;
+        }
+
+        /// <summary>
+        /// Stop the threads and the streams.
+        /// </summary>
+        public void Stop()
+        {
+            if (!IsRunning) return;
+
+            _stopRequested = true;
+            foreach (var thread in _threads) thread.Join();
+            _threads = new Thread[0];
+            foreach (var stream in _streams)
+            {
+                stream.RemoveSink(_latency);
+                stream.Stop();
+            }
+        }
+
+        private void Pin(int index)
+        {
+            var cores = Options.Cores;
+            if (cores == null || cores.Length == 0) return;
+            if (ThreadAffinity.PinCurrentThread(cores[index % cores.Length])) Interlocked.Increment(ref _pinnedThreads);
+        }
+
+        private void RunBlocking(int index, SensorStream stream)
+        {
+            Pin(index);
+            while (!_stopRequested)
+            {
+                stream.Wait(Options.BlockingTimeoutMilliseconds);
+            }
+        }
+
+        private void RunBusyPoll(int index, SensorStream[] streams)
+        {
+            Pin(index);
+            var watch = Stopwatch.StartNew();
+            var spinTicks = (long)(Options.SpinMicroseconds * (Stopwatch.Frequency / 1000000.0));
+            var lastPacket = watch.ElapsedTicks;
+
+            while (!_stopRequested)
+            {
+                var any = false;
+                for (var s = 0; s < streams.Length; s++)
+                {
+                    if (streams[s].Poll()) any = true;
+                }
+
+                if (any)
+                {
+                    lastPacket = watch.ElapsedTicks;
+                }
+                else if (watch.ElapsedTicks - lastPacket > spinTicks)
+                {
+                    Interlocked.Increment(ref _parks);
+                    Thread.Sleep(Options.ParkMilliseconds);
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            Stop();
+            _isDisposed = true;
+        }
+
+        /// <summary>
+        /// Runs after the user's sinks, so the recorded latency covers them.
+        /// </summary>
+        private class LatencySink : IStreamSink
+        {
+            private readonly LowLatencyAcquisition _owner;
+
+            public LatencySink(LowLatencyAcquisition owner)
+            {
+                _owner = owner;
+            }
+
+            public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+            {
+                _owner.Latency.Record(unchecked((int)((uint)_owner.Clock() - sample.TimeStamp)));
+            }
+        }
+    }
+}
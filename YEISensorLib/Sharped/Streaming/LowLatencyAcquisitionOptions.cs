@@ -0,0 +1,62 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    public class LowLatencyAcquisitionOptions
+    {
+        /// <summary>
+        /// BusyPoll by default. On a single core Blocking is used instead: a spinning thread would take the core
+        /// from the threads delivering the packets.
+        /// </summary>
+        public AcquisitionModeEnum Mode { get; set; }
+
+        /// <summary>
+        /// Busy poll threads, the streams are spread over them. Blocking mode uses one thread per stream.
+        /// At most one less than the core count is started, so the threads filling the stream buffers keep a core.
+        /// </summary>
+        public int Threads { get; set; }
+
+        /// <summary>
+        /// Cores the threads are pinned to, in turn. Empty leaves them to the scheduler.
+        /// </summary>
+        public int[] Cores { get; set; }
+
+        /// <summary>
+        /// Priority of the acquisition threads, Normal by default. Raise it only with cores to spare:
+        /// spinning threads above normal starve the threads delivering the packets.
+        /// </summary>
+        public ThreadPriority Priority { get; set; }
+
+        /// <summary>
+        /// Busy poll: keep spinning this long after the last packet before parking.
+        /// Above the stream interval the thread never parks while data flows.
+        /// </summary>
+        public uint SpinMicroseconds { get; set; }
+
+        /// <summary>
+        /// Busy poll: sleep per park, until a packet shows up again.
+        /// </summary>
+        public int ParkMilliseconds { get; set; }
+
+        /// <summary>
+        /// Blocking: timeout of each tss_getLatestStreamData, the thread checks for Stop in between.
+        /// </summary>
+        public uint BlockingTimeoutMilliseconds { get; set; }
+
+        public LowLatencyAcquisitionOptions()
+        {
+            Mode = AcquisitionModeEnum.BusyPoll;
+            Threads = 1;
+            Cores = new int[0];
+            Priority = ThreadPriority.Normal;
+            SpinMicroseconds = 20000;
+            ParkMilliseconds = 1;
+            BlockingTimeoutMilliseconds = 100;
+        }
+    }
+}
@@ -0,0 +1,23 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Arithmetic on the sensors' 32 bit microsecond timestamps.
+    /// </summary>
+    internal static class SensorClock
+    {
+        /// <summary>
+        /// Time from previous to current. Wraps of the clock count forward, steps back (sensor reset, timestamp update)
+        /// count as 0.
+        /// </summary>
+        public static long ElapsedMicroseconds(uint previous, uint current)
+        {
+            return Math.Max(0, unchecked((int)(current - previous)));
+        }
+    }
+}
@@ -0,0 +1,158 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// A bounded queue of samples between a SensorStream and an asynchronous consumer.
+    /// 
+    /// Attach it to a stream as a sink and read with WaitToReadAsync/TryRead or ForEachAsync.
+    /// Waiting consumers hold no thread, so hundreds of streams can be consumed from a few threads.
+    /// Writers never block: when full, samples are dropped per FullMode and counted in Dropped.
+    /// </summary>
+    public class SensorSampleChannel : IStreamSink
+    {
+        private readonly object _lock = new object();
+        private readonly SensorSample[] _buffer;
+        private int _head;
+        private int _count;
+        private bool _isCompleted;
+        private TaskCompletionSource<bool> _waiter;
+        private long _dropped;
+
+        public int Capacity { get { return _buffer.Length; } }
+
+        public ChannelFullModeEnum FullMode { get; private set; }
+
+        /// <summary>
+        /// Samples shed because the consumer fell behind.
+        /// </summary>
+        public long Dropped { get { return Interlocked.Read(ref _dropped); } }
+
+        public int Count
+        {
+            get { lock (_lock) return _count; }
+        }
+
+        public SensorSampleChannel(int capacity, ChannelFullModeEnum fullMode)
+        {
+            if (capacity <= 0) throw new ArgumentOutOfRangeException("capacity");
+            _buffer = new SensorSample[capacity];
+            FullMode = fullMode;
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            Write(ref sample);
+        }
+
+        /// <summary>
+        /// Queue a sample.
+        /// </summary>
+        /// <returns>False if the sample was dropped or the channel is completed.</returns>
+        public bool Write(ref SensorSample sample)
+        {
+            TaskCompletionSource<bool> waiter;
+            lock (_lock)
+            {
+                if (_isCompleted) return false;
+                if (_count == _buffer.Length)
+                {
+                    Interlocked.Increment(ref _dropped);
+                    if (FullMode == ChannelFullModeEnum.DropNewest) return false;
+                    _head = (_head + 1) % _buffer.Length;
+                    _count--;
+                }
+                _buffer[(_head + _count) % _buffer.Length] = sample;
+                _count++;
+                waiter = _waiter;
+                _waiter = null;
+            }
+            Release(waiter, true);
+            return true;
+        }
+
+        /// <summary>
+        /// Take the oldest queued sample without waiting.
+        /// </summary>
+        public bool TryRead(out SensorSample sample)
+        {
+            lock (_lock)
+            {
+                if (_count == 0)
+                {
+                    sample = new SensorSample();
+                    return false;
+                }
+                sample = _buffer[_head];
+                _head = (_head + 1) % _buffer.Length;
+                _count--;
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Completes with true once a sample can be read, or false once the channel is completed and drained.
+        /// </summary>
+        public Task<bool> WaitToReadAsync(CancellationToken cancellationToken = default(CancellationToken))
+        {
+            Task<bool> wait;
+            lock (_lock)
+            {
+                if (_count > 0) return Task.FromResult(true);
+                if (_isCompleted) return Task.FromResult(false);
+                if (_waiter == null) _waiter = new TaskCompletionSource<bool>();
+                wait = _waiter.Task;
+            }
+            if (!cancellationToken.CanBeCanceled) return wait;
+
+            var cancellable = new TaskCompletionSource<bool>();
+            var registration = cancellationToken.Register(() => cancellable.TrySetCanceled());
+            //Released however the wait ends, so waits on a long lived token do not leave registrations behind.
+            cancellable.Task.ContinueWith(t => registration.Dispose(), TaskContinuationOptions.ExecuteSynchronously);
+            wait.ContinueWith(t => cancellable.TrySetResult(t.Result), TaskContinuationOptions.ExecuteSynchronously);
+            return cancellable.Task;
+        }
+
+        /// <summary>
+        /// Hand every sample to handler until the channel is completed or the token is cancelled.
+        /// </summary>
+        public async Task ForEachAsync(Action<SensorSample> handler, CancellationToken cancellationToken = default(CancellationToken))
+        {
+            while (await WaitToReadAsync(cancellationToken).ConfigureAwait(false))
+            {
+                SensorSample sample;
+                while (TryRead(out sample))
+                {
+                    handler(sample);
+                }
+            }
+        }
+
+        /// <summary>
+        /// No more samples will be written. Readers drain what is queued and then stop.
+        /// </summary>
+        public void Complete()
+        {
+            TaskCompletionSource<bool> waiter;
+            lock (_lock)
+            {
+                _isCompleted = true;
+                waiter = _waiter;
+                _waiter = null;
+            }
+            Release(waiter, false);
+        }
+
+        private static void Release(TaskCompletionSource<bool> waiter, bool result)
+        {
+            if (waiter == null) return;
+            //Never run the consumer's continuation on the acquisition thread.
+            ThreadPool.UnsafeQueueUserWorkItem(_ => waiter.TrySetResult(result), null);
+        }
+    }
+}
@@ -0,0 +1,359 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Streams a sensor and hands every decoded packet to the attached sinks.
+    /// 
+    /// Packets are delivered by the API's new data callback on the API's own thread,
+    /// so a stream does not cost a thread of its own.
+    /// A stream started with StartPolled has no callback, packets reach the sinks when Poll or Wait reads them
+    /// (see LowLatencyAcquisition).
+    /// </summary>
+    public class SensorStream : IDisposable
+    {
+        public const int MaxSlots = 8;
+
+        /// <summary>
+        /// Largest packet any layout of MaxSlots slots can produce (9 floats per slot).
+        /// </summary>
+        public const int MaxPayloadSize = MaxSlots * 36;
+
+        private bool _isDisposed;
+
+        private readonly object _sinkLock = new object();
+        private IStreamSink[] _sinks = new IStreamSink[0];
+
+        //Held in a field so the delegate outlives its registration with the API.
+        private readonly StreamDataCallback _callback;
+        private readonly byte[] _payload;
+        private byte[] _polledPayload;
+        private byte[] _polledScratch;
+        private uint _polledTimeStamp;
+        private SensorSample _sample;
+
+        private long _packetsReceived;
+        private long _malformedPackets;
+        private long _stalePackets;
+
+        //Set while a layout change is under way and until the first packet of the new layout.
+        private LayoutChange _layoutChange;
+        private long _sinkErrors;
+
+        public SensorDevice Device { get; private set; }
+
+        /// <summary>
+        /// The streamed slots, see SetLayout.
+        /// </summary>
+        public StreamSlotLayout Layout { get; private set; }
+
+        /// <summary>
+        /// Layout of the packet being dispatched, for sinks. Packets whose layout is not known for sure during a
+        /// layout change are dropped, see StalePackets.
+        /// </summary>
+        public StreamSlotLayout PacketLayout { get; private set; }
+
+        /// <summary>
+        /// Microseconds between packets.
+        /// </summary>
+        public uint IntervalMicroseconds { get; private set; }
+
+        /// <summary>
+        /// Returns true while the sensor is streaming.
+        /// </summary>
+        public bool IsStreaming { get; private set; }
+
+        /// <summary>
+        /// True if streaming was started with StartPolled.
+        /// </summary>
+        public bool IsPolled { get; private set; }
+
+        public long PacketsReceived { get { return Interlocked.Read(ref _packetsReceived); } }
+
+        /// <summary>
+        /// Packets whose size does not match the layout, dropped.
+        /// </summary>
+        public long MalformedPackets { get { return Interlocked.Read(ref _malformedPackets); } }
+
+        /// <summary>
+        /// Packets dropped during a layout change: those arriving while the sensor is reconfigured,
+        /// and those stamped before the sensor answered.
+        /// </summary>
+        public long StalePackets { get { return Interlocked.Read(ref _stalePackets); } }
+
+        /// <summary>
+        /// Exceptions thrown by sinks, they are swallowed so they never unwind into the API thread.
+        /// </summary>
+        public long SinkErrors { get { return Interlocked.Read(ref _sinkErrors); } }
+
+        /// <summary>
+        /// The most recent sample.
+        /// </summary>
+        public SensorSample LatestSample { get { return _sample; } }
+
+        /// <summary>
+        /// Create a stream, call Start to begin streaming.
+        /// </summary>
+        /// <param name="device">The sensor to stream.</param>
+        /// <param name="layout">The commands to stream, at most 8.</param>
+        /// <param name="intervalMicroseconds">Microseconds between packets, 0 for as fast as possible.</param>
+        public SensorStream(SensorDevice device, StreamSlotLayout layout, uint intervalMicroseconds)
+        {
+            Device = device;
+            Layout = layout;
+            PacketLayout = layout;
+            IntervalMicroseconds = intervalMicroseconds;
+            _payload = new byte[MaxPayloadSize];
+            _callback = OnData;
+        }
+
+        public void AddSink(IStreamSink sink)
+        {
+            lock (_sinkLock)
+            {
+                _sinks = _sinks.Concat(new[] { sink }).ToArray();
+            }
+        }
+
+        public void RemoveSink(IStreamSink sink)
+        {
+            lock (_sinkLock)
+            {
+                _sinks = _sinks.Where(s => s != sink).ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Configure the slots and timing on the sensor and start streaming.
+        /// </summary>
+        /// <returns>False if the sensor rejected the configuration.</returns>
+        public bool Start()
+        {
+            return Start(_callback);
+        }
+
+        /// <summary>
+        /// Start streaming without the API callback. Packets are then only read by Poll or Wait,
+        /// and the sinks run on the thread calling them. Only one thread may read a polled stream.
+        /// </summary>
+        /// <returns>False if the sensor rejected the configuration.</returns>
+        public bool StartPolled()
+        {
+            _polledPayload = new byte[MaxPayloadSize];
+            _polledScratch = new byte[MaxPayloadSize];
+            return Start(null);
+        }
+
+        private bool Start(StreamDataCallback callback)
+        {
+            if (IsStreaming) return true;
+            if (!Device.IsConnected || Device.IsDongle || Layout.Slots.Length > MaxSlots) return false;
+
+            if (!Device.StartStreaming(this, callback)) return false;
+
+            IsPolled = callback == null;
+            IsStreaming = true;
+            return true;
+        }
+
+        /// <summary>
+        /// Read the last packet of a polled stream without waiting (tss_getLastStreamData)
+        /// and dispatch it if it was not seen before.
+        /// </summary>
+        /// <returns>True if a new packet was dispatched.</returns>
+        public bool Poll()
+        {
+            if (!IsStreaming || !IsPolled) return false;
+
+            uint timeStamp;
+            if (Device.ReadLastStreamData(this, _polledScratch, out timeStamp) != ResultEnum.NoError) return false;
+            StreamSlotLayout layout;
+            if (!Accept(timeStamp, out layout)) return false;
+            if (_packetsReceived > 0 && timeStamp == _polledTimeStamp && SamePayload(_polledScratch, _polledPayload, layout.PayloadSize)) return false;
+
+            DispatchPolled(layout, timeStamp);
+            return true;
+        }
+
+        /// <summary>
+        /// Wait up to timeoutMilliseconds for the next packet of a polled stream (tss_getLatestStreamData) and dispatch it.
+        /// </summary>
+        /// <returns>False on timeout or error.</returns>
+        public bool Wait(uint timeoutMilliseconds)
+        {
+            if (!IsStreaming || !IsPolled) return false;
+
+            uint timeStamp;
+            if (Device.ReadLatestStreamData(this, _polledScratch, timeoutMilliseconds, out timeStamp) != ResultEnum.NoError) return false;
+            StreamSlotLayout layout;
+            if (!Accept(timeStamp, out layout)) return false;
+
+            DispatchPolled(layout, timeStamp);
+            return true;
+        }
+
+        private void DispatchPolled(StreamSlotLayout layout, uint timeStamp)
+        {
+            //The scratch buffer becomes the dispatched packet, the previous one is compared against by the next Poll.
+            var payload = _polledScratch;
+            _polledScratch = _polledPayload;
+            _polledPayload = payload;
+            _polledTimeStamp = timeStamp;
+            Dispatch(layout, payload, timeStamp);
+        }
+
+        private static bool SamePayload(byte[] a, byte[] b, int length)
+        {
+            for (var i = 0; i < length; i++)
+            {
+                if (a[i] != b[i]) return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Stop streaming and unregister from the API.
+        /// </summary>
+        public void Stop()
+        {
+            if (!IsStreaming) return;
+            Device.StopStreaming(this);
+            IsStreaming = false;
+            IsPolled = false;
+        }
+
+        /// <summary>
+        /// Change the streamed slots. While streaming the sensor is reconfigured without stopping.
+        /// Packets arriving meanwhile, and later ones stamped before the sensor's answer, are dropped,
+        /// the rest are decoded with the new layout.
+        /// Values the new layout does not carry keep their last decoded value in the samples.
+        /// </summary>
+        /// <returns>False if the sensor rejected the layout, the old one stays in use.</returns>
+        public bool SetLayout(StreamSlotLayout layout)
+        {
+            if (layout.Slots.Length > MaxSlots) return false;
+            if (!IsStreaming)
+            {
+                Layout = layout;
+                return true;
+            }
+
+            Volatile.Write(ref _layoutChange, new LayoutChange(null, 0));
+            uint timeStamp;
+            if (!Device.ChangeStreamingSlots(this, layout, out timeStamp))
+            {
+                Volatile.Write(ref _layoutChange, null);
+                return false;
+            }
+            Layout = layout;
+            Volatile.Write(ref _layoutChange, new LayoutChange(layout, timeStamp));
+            return true;
+        }
+
+        /// <summary>
+        /// Decode a packet and hand it to the sinks.
+        /// </summary>
+        /// <param name="layout">Layout of the packet.</param>
+        /// <param name="payload">Packet laid out as layout.</param>
+        /// <param name="timeStamp">Timestamp of the packet.</param>
+        protected internal void Dispatch(StreamSlotLayout layout, byte[] payload, uint timeStamp)
+        {
+            layout.Decode(payload, 0, timeStamp, ref _sample);
+            PacketLayout = layout;
+            Interlocked.Increment(ref _packetsReceived);
+
+            var sinks = _sinks;
+            for (var i = 0; i < sinks.Length; i++)
+            {
+                try
+                {
+                    sinks[i].OnSample(this, ref _sample, payload);
+                }
+                catch (Exception)
+                {
+                    Interlocked.Increment(ref _sinkErrors);
+                }
+            }
+        }
+
+        private void OnData(uint deviceId, IntPtr outputData, uint outputDataLength, IntPtr timeStampPointer)
+        {
+            var timeStamp = timeStampPointer == IntPtr.Zero ? 0u : (uint)Marshal.ReadInt32(timeStampPointer);
+            StreamSlotLayout layout;
+            if (!Accept(timeStamp, out layout)) return;
+            if (outputData == IntPtr.Zero || outputDataLength != layout.PayloadSize)
+            {
+                Interlocked.Increment(ref _malformedPackets);
+                return;
+            }
+            Marshal.Copy(outputData, _payload, 0, layout.PayloadSize);
+            Dispatch(layout, _payload, timeStamp);
+        }
+
+        /// <summary>
+        /// The layout of a packet read from the API, false if it is not known for sure (a layout change is under way,
+        /// or the packet was stamped before the sensor took the new layout).
+        /// </summary>
+        private bool Accept(uint timeStamp, out StreamSlotLayout layout)
+        {
+            var change = Volatile.Read(ref _layoutChange);
+            if (change == null)
+            {
+                layout = Layout;
+                return true;
+            }
+
+            layout = change.Layout;
+            if (layout == null || unchecked((int)(timeStamp - change.TimeStamp)) < 0)
+            {
+                Interlocked.Increment(ref _stalePackets);
+                return false;
+            }
+            Interlocked.CompareExchange(ref _layoutChange, null, change);
+            return true;
+        }
+
+        /// <summary>
+        /// The 8 slot bytes tss_setStreamingSlots expects, unused slots set to TSS_NULL.
+        /// </summary>
+        public static byte[] SlotBytes(StreamSlotLayout layout)
+        {
+            var slots = Enumerable.Repeat((byte)StreamCommandEnum.Null, MaxSlots).ToArray();
+            for (var i = 0; i < layout.Slots.Length && i < MaxSlots; i++) slots[i] = (byte)layout.Slots[i];
+            return slots;
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            Stop();
+            _isDisposed = true;
+        }
+
+        private class LayoutChange
+        {
+            /// <summary>
+            /// The new layout, null while the sensor is being reconfigured.
+            /// </summary>
+            public readonly StreamSlotLayout Layout;
+
+            /// <summary>
+            /// Timestamp of the sensor's answer, packets stamped earlier still carry the old layout.
+            /// </summary>
+            public readonly uint TimeStamp;
+
+            public LayoutChange(StreamSlotLayout layout, uint timeStamp)
+            {
+                Layout = layout;
+                TimeStamp = timeStamp;
+            }
+        }
+    }
+}
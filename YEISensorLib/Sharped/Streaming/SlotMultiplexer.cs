@@ -0,0 +1,183 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Async;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Streams more quantities than the 8 slots tss_setStreamingSlots allows.
+    /// 
+    /// Pinned quantities are in every packet. The remaining slots are spare: every DwellPackets packets the
+    /// rotated quantities closest to missing their minimum rate (earliest deadline first) are swapped into them,
+    /// with one tss_setStreamingSlots on the command scheduler, so the acquisition thread never waits on it.
+    /// Each quantity keeps its last known value, and the stream's samples keep the last decoded vectors,
+    /// so nothing is polled while streaming.
+    /// 
+    /// Usage:
+    ///     var mux = new SlotMultiplexer(device, 10000,
+    ///         StreamQuantity.Every(StreamCommandEnum.TaredOrientationAsQuaternion),
+    ///         StreamQuantity.Every(StreamCommandEnum.AllCorrectedComponentSensorData),
+    ///         StreamQuantity.AtLeast(StreamCommandEnum.BatteryPercentRemaining, 0.2));
+    ///     mux.Stream.AddSink(...);
+    ///     mux.Start();
+    /// Sinks of a multiplexed stream see packets of changing layouts, they must use stream.PacketLayout to read a payload.
+    /// </summary>
+    public class SlotMultiplexer : IStreamSink, IDisposable
+    {
+        private bool _isDisposed;
+
+        private readonly StreamQuantity[] _pinned;
+        private readonly StreamQuantity[] _rotated;
+        private readonly Dictionary<StreamCommandEnum, StreamQuantity> _byCommand;
+        private readonly int _spareSlots;
+
+        private int _packetsSinceRotation;
+        private int _rotating;
+        private long _rotations;
+        private long _rejectedRotations;
+
+        public SensorStream Stream { get; private set; }
+
+        public IList<StreamQuantity> Quantities { get; private set; }
+
+        /// <summary>
+        /// Packets streamed between two rotations of the spare slots, at least 1.
+        /// </summary>
+        public int DwellPackets { get; set; }
+
+        public long Rotations { get { return Interlocked.Read(ref _rotations); } }
+
+        /// <summary>
+        /// Rotations the sensor did not accept, the previous slots stayed in use.
+        /// </summary>
+        public long RejectedRotations { get { return Interlocked.Read(ref _rejectedRotations); } }
+
+        /// <summary>
+        /// Slot visits per second the rotated quantities' minimum rates need.
+        /// </summary>
+        public double RequiredVisitsPerSecond
+        {
+            get { return _rotated.Sum(q => q.MinimumRate); }
+        }
+
+        /// <summary>
+        /// Slot visits per second the spare slots offer at the stream interval, ignoring the command round trip.
+        /// </summary>
+        public double AvailableVisitsPerSecond
+        {
+            get
+            {
+                if (_rotated.Length == 0) return 0;
+                if (Stream.IntervalMicroseconds == 0) return double.PositiveInfinity;
+                return _spareSlots * 1000000.0 / (Math.Max(1, DwellPackets) * (double)Stream.IntervalMicroseconds);
+            }
+        }
+
+        /// <summary>
+        /// True if every minimum rate can be met.
+        /// </summary>
+        public bool IsFeasible
+        {
+            get { return RequiredVisitsPerSecond <= AvailableVisitsPerSecond; }
+        }
+
+        /// <param name="device">The sensor to stream.</param>
+        /// <param name="intervalMicroseconds">Microseconds between packets.</param>
+        /// <param name="quantities">What to stream, each command once. Quantities that fit into 8 slots are all pinned.</param>
+        public SlotMultiplexer(SensorDevice device, uint intervalMicroseconds, params StreamQuantity[] quantities)
+        {
+            if (quantities.Select(q => q.Command).Distinct().Count() != quantities.Length)
+                throw new ArgumentException("Each command can only be scheduled once.", "quantities");
+
+            var all = quantities.Where(q => q.Command != StreamCommandEnum.Null).ToArray();
+            var fits = all.Length <= SensorStream.MaxSlots;
+            _pinned = fits ? all : all.Where(q => q.Pinned).ToArray();
+            _rotated = fits ? new StreamQuantity[0] : all.Where(q => !q.Pinned).ToArray();
+            _spareSlots = SensorStream.MaxSlots - _pinned.Length;
+            if (_spareSlots < 0 || (_rotated.Length > 0 && _spareSlots == 0))
+                throw new ArgumentOutOfRangeException("quantities", "At most 7 quantities can be pinned when others are rotated.");
+
+            _byCommand = all.ToDictionary(q => q.Command);
+            Quantities = new ReadOnlyCollection<StreamQuantity>(all);
+            DwellPackets = 2;
+
+            Stream = new SensorStream(device, NextLayout(0), intervalMicroseconds);
+            Stream.AddSink(this);
+        }
+
+        public bool Start()
+        {
+            return Stream.Start();
+        }
+
+        public void Stop()
+        {
+            Stream.Stop();
+        }
+
+        public void OnSample(SensorStream stream, ref SensorSample sample, byte[] payload)
+        {
+            var layout = stream.PacketLayout;
+            for (var slot = 0; slot < layout.Slots.Length; slot++)
+            {
+                StreamQuantity quantity;
+                if (_byCommand.TryGetValue(layout.Slots[slot], out quantity))
+                {
+                    quantity.Update(payload, layout.OffsetOfSlot(slot), sample.TimeStamp);
+                }
+            }
+
+            if (_rotated.Length == 0) return;
+            if (Interlocked.Increment(ref _packetsSinceRotation) < DwellPackets) return;
+            if (Interlocked.CompareExchange(ref _rotating, 1, 0) != 0) return;
+            Rotate(sample.TimeStamp);
+        }
+
+        private void Rotate(uint now)
+        {
+            var layout = NextLayout(now);
+            if (layout.Slots.SequenceEqual(Stream.Layout.Slots))
+            {
+                //Nothing to rotate, the sensor is not reconfigured for the same slots.
+                Interlocked.Exchange(ref _packetsSinceRotation, 0);
+                Volatile.Write(ref _rotating, 0);
+                return;
+            }
+            Stream.Device.InvokeAsync(id =>
+            {
+                var accepted = Stream.SetLayout(layout);
+                return new CommandResult<bool>(accepted ? ResultEnum.NoError : ResultEnum.ErrorCommandFail, accepted, 0);
+            }).ContinueWith(task =>
+            {
+                if (task.Status == TaskStatus.RanToCompletion && task.Result.Success) Interlocked.Increment(ref _rotations);
+                else Interlocked.Increment(ref _rejectedRotations);
+                Interlocked.Exchange(ref _packetsSinceRotation, 0);
+                Volatile.Write(ref _rotating, 0);
+            }, TaskContinuationOptions.ExecuteSynchronously);
+        }
+
+        /// <summary>
+        /// The pinned quantities, plus the rotated ones with the earliest deadlines in the spare slots.
+        /// Deadlines run on sensor timestamps, so a replayed session is scheduled like the live one.
+        /// </summary>
+        private StreamSlotLayout NextLayout(uint now)
+        {
+            var commands = _pinned.Select(q => q.Command).ToList();
+            commands.AddRange(_rotated.OrderBy(q => q.Slack(now)).Take(_spareSlots).Select(q => q.Command));
+            return new StreamSlotLayout(commands.ToArray());
+        }
+
+        public void Dispose()
+        {
+            if (_isDisposed) return;
+            Stream.Dispose();
+            _isDisposed = true;
+        }
+    }
+}
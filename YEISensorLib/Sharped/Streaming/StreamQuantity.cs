@@ -0,0 +1,114 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// A streamed value scheduled by a SlotMultiplexer, with its last known value.
+    /// </summary>
+    public class StreamQuantity
+    {
+        private readonly object _lock = new object();
+        private readonly float[] _values;
+        private uint _timeStamp;
+        private long _updates;
+        private long _longestGap;
+
+        public StreamCommandEnum Command { get; private set; }
+
+        /// <summary>
+        /// Streamed in every packet.
+        /// </summary>
+        public bool Pinned { get; private set; }
+
+        /// <summary>
+        /// Updates per second a rotated quantity must get at least.
+        /// </summary>
+        public double MinimumRate { get; private set; }
+
+        public long Updates { get { return Interlocked.Read(ref _updates); } }
+
+        /// <summary>
+        /// Longest time between two updates, from sensor timestamps.
+        /// </summary>
+        public TimeSpan LongestGap { get { return TimeSpan.FromTicks(Interlocked.Read(ref _longestGap) * 10); } }
+
+        private StreamQuantity(StreamCommandEnum command, bool pinned, double minimumRate)
+        {
+            Command = command;
+            Pinned = pinned;
+            MinimumRate = minimumRate;
+            _values = new float[StreamSlotLayout.ValueCount(command)];
+        }
+
+        /// <summary>
+        /// A quantity streamed in every packet.
+        /// </summary>
+        public static StreamQuantity Every(StreamCommandEnum command)
+        {
+            return new StreamQuantity(command, true, 0);
+        }
+
+        /// <summary>
+        /// A quantity rotated through the spare slots, updated at least minimumRate times per second.
+        /// </summary>
+        public static StreamQuantity AtLeast(StreamCommandEnum command, double minimumRate)
+        {
+            if (minimumRate <= 0) throw new ArgumentOutOfRangeException("minimumRate");
+            return new StreamQuantity(command, false, minimumRate);
+        }
+
+        /// <summary>
+        /// Copy the last known values (bytes are widened to float).
+        /// </summary>
+        /// <param name="values">Receives StreamSlotLayout.ValueCount(Command) values.</param>
+        /// <param name="timeStamp">Sensor timestamp of the update.</param>
+        /// <returns>False if the quantity was never received.</returns>
+        public bool TryGetValues(float[] values, out uint timeStamp)
+        {
+            lock (_lock)
+            {
+                timeStamp = _timeStamp;
+                if (_updates == 0) return false;
+                Array.Copy(_values, values, _values.Length);
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Microseconds left until the minimum rate is missed, negative once late.
+        /// </summary>
+        internal double Slack(uint now)
+        {
+            lock (_lock)
+            {
+                if (_updates == 0) return double.MinValue;
+                return 1000000.0 / MinimumRate - unchecked(now - _timeStamp);
+            }
+        }
+
+        internal void Update(byte[] payload, int offset, uint timeStamp)
+        {
+            var isByte = StreamSlotLayout.IsByteValued(Command);
+            lock (_lock)
+            {
+                for (var i = 0; i < _values.Length; i++)
+                {
+                    _values[i] = isByte ? payload[offset + i] : BitConverter.ToSingle(payload, offset + i * 4);
+                }
+                if (_updates > 0)
+                {
+                    long gap = unchecked(timeStamp - _timeStamp);
+                    if (gap > _longestGap) Interlocked.Exchange(ref _longestGap, gap);
+                }
+                _timeStamp = timeStamp;
+                Interlocked.Increment(ref _updates);
+            }
+        }
+    }
+}
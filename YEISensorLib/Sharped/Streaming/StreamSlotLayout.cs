@@ -0,0 +1,181 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Describes how the values of a set of streaming slots are packed into one stream packet.
+    /// The API hands back each slot's output back to back, floats in host byte order.
+    /// </summary>
+    public class StreamSlotLayout
+    {
+        private readonly int[] _offsets;
+
+        /// <summary>
+        /// The streamed commands, in slot order. TSS_NULL slots are dropped.
+        /// </summary>
+        public StreamCommandEnum[] Slots { get; private set; }
+
+        /// <summary>
+        /// Size in bytes of one packet of stream data.
+        /// </summary>
+        public int PayloadSize { get; private set; }
+
+        public StreamSlotLayout(params StreamCommandEnum[] slots)
+        {
+            Slots = slots.Where(s => s != StreamCommandEnum.Null).ToArray();
+            _offsets = new int[Slots.Length];
+            var offset = 0;
+            for (var i = 0; i < Slots.Length; i++)
+            {
+                _offsets[i] = offset;
+                offset += ByteSize(Slots[i]);
+            }
+            PayloadSize = offset;
+        }
+
+        /// <summary>
+        /// Byte offset of the slot's output within a packet.
+        /// </summary>
+        public int OffsetOfSlot(int slot)
+        {
+            return _offsets[slot];
+        }
+
+        /// <summary>
+        /// Byte offset of the command's output within a packet, or -1 if it is not streamed.
+        /// </summary>
+        public int OffsetOf(StreamCommandEnum command)
+        {
+            var slot = Array.IndexOf(Slots, command);
+            return slot < 0 ? -1 : _offsets[slot];
+        }
+
+        /// <summary>
+        /// Copies every value the layout carries into the matching fields of sample.
+        /// Fields not streamed are left untouched.
+        /// </summary>
+        public void Decode(byte[] payload, int payloadOffset, uint timeStamp, ref SensorSample sample)
+        {
+            sample.TimeStamp = timeStamp;
+            for (var i = 0; i < Slots.Length; i++)
+            {
+                var offset = payloadOffset + _offsets[i];
+                switch (Slots[i])
+                {
+                    case StreamCommandEnum.TaredOrientationAsQuaternion:
+                    case StreamCommandEnum.UntaredOrientationAsQuaternion:
+                        sample.Quaternion = ReadQuaternion(payload, offset);
+                        break;
+                    case StreamCommandEnum.AllNormalizedComponentSensorData:
+                    case StreamCommandEnum.AllCorrectedComponentSensorData:
+                    case StreamCommandEnum.AllRawComponentSensorData:
+                        sample.Gyro = ReadVector(payload, offset);
+                        sample.Accelerometer = ReadVector(payload, offset + 12);
+                        sample.Compass = ReadVector(payload, offset + 24);
+                        break;
+                    case StreamCommandEnum.NormalizedGyroRate:
+                    case StreamCommandEnum.CorrectedGyroRate:
+                    case StreamCommandEnum.RawGyroscopeRate:
+                        sample.Gyro = ReadVector(payload, offset);
+                        break;
+                    case StreamCommandEnum.NormalizedAccelerometerVector:
+                    case StreamCommandEnum.CorrectedAccelerometerVector:
+                    case StreamCommandEnum.RawAccelerometerData:
+                        sample.Accelerometer = ReadVector(payload, offset);
+                        break;
+                    case StreamCommandEnum.NormalizedCompassVector:
+                    case StreamCommandEnum.CorrectedCompassVector:
+                    case StreamCommandEnum.RawCompassData:
+                        sample.Compass = ReadVector(payload, offset);
+                        break;
+                    case StreamCommandEnum.ButtonState:
+                        sample.Buttons = ButtonState.FromBitfield(payload[offset], timeStamp);
+                        break;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Number of values a command outputs.
+        /// </summary>
+        public static int ValueCount(StreamCommandEnum command)
+        {
+            switch (command)
+            {
+                case StreamCommandEnum.TaredOrientationAsQuaternion:
+                case StreamCommandEnum.TaredOrientationAsAxisAngle:
+                case StreamCommandEnum.DifferenceQuaternion:
+                case StreamCommandEnum.UntaredOrientationAsQuaternion:
+                case StreamCommandEnum.UntaredOrientationAsAxisAngle:
+                    return 4;
+                case StreamCommandEnum.TaredOrientationAsRotationMatrix:
+                case StreamCommandEnum.UntaredOrientationAsRotationMatrix:
+                case StreamCommandEnum.AllNormalizedComponentSensorData:
+                case StreamCommandEnum.AllCorrectedComponentSensorData:
+                case StreamCommandEnum.AllRawComponentSensorData:
+                    return 9;
+                case StreamCommandEnum.TaredOrientationAsTwoVector:
+                case StreamCommandEnum.UntaredOrientationAsTwoVector:
+                case StreamCommandEnum.TaredTwoVectorInSensorFrame:
+                case StreamCommandEnum.UntaredTwoVectorInSensorFrame:
+                    return 6;
+                case StreamCommandEnum.TemperatureC:
+                case StreamCommandEnum.TemperatureF:
+                case StreamCommandEnum.ConfidenceFactor:
+                case StreamCommandEnum.BatteryVoltage:
+                case StreamCommandEnum.BatteryPercentRemaining:
+                case StreamCommandEnum.BatteryStatus:
+                case StreamCommandEnum.ButtonState:
+                    return 1;
+                case StreamCommandEnum.Null:
+                    return 0;
+                default:
+                    return 3;
+            }
+        }
+
+        /// <summary>
+        /// True if the command outputs single bytes rather than floats.
+        /// </summary>
+        public static bool IsByteValued(StreamCommandEnum command)
+        {
+            return command == StreamCommandEnum.BatteryPercentRemaining
+                   || command == StreamCommandEnum.BatteryStatus
+                   || command == StreamCommandEnum.ButtonState;
+        }
+
+        /// <summary>
+        /// Size in bytes of a command's output.
+        /// </summary>
+        public static int ByteSize(StreamCommandEnum command)
+        {
+            return ValueCount(command) * (IsByteValued(command) ? 1 : 4);
+        }
+
+        public static Vector3F ReadVector(byte[] payload, int offset)
+        {
+            return new Vector3F
+                       {
+                           X = BitConverter.ToSingle(payload, offset),
+                           Y = BitConverter.ToSingle(payload, offset + 4),
+                           Z = BitConverter.ToSingle(payload, offset + 8)
+                       };
+        }
+
+        public static Quaternion ReadQuaternion(byte[] payload, int offset)
+        {
+            return new Quaternion
+                       {
+                           X = BitConverter.ToSingle(payload, offset),
+                           Y = BitConverter.ToSingle(payload, offset + 4),
+                           Z = BitConverter.ToSingle(payload, offset + 8),
+                           W = BitConverter.ToSingle(payload, offset + 12)
+                       };
+        }
+    }
+}
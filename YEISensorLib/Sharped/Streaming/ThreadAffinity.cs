@@ -0,0 +1,54 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Streaming
+{
+    /// <summary>
+    /// Pins the calling thread to a core, on Windows (SetThreadAffinityMask) and Linux (sched_setaffinity).
+    /// </summary>
+    internal static class ThreadAffinity
+    {
+        /// <returns>False if the core does not exist or the platform does not support it.</returns>
+        public static bool PinCurrentThread(int core)
+        {
+            if (core < 0 || core >= Environment.ProcessorCount) return false;
+
+            try
+            {
+                //The OS thread must stay under this managed thread for the mask to mean anything.
+                Thread.BeginThreadAffinity();
+                if (Environment.OSVersion.Platform == PlatformID.Win32NT)
+                {
+                    if (core >= 64) return false;
+                    return SetThreadAffinityMask(GetCurrentThread(), new UIntPtr(1UL << core)) != UIntPtr.Zero;
+                }
+
+                var mask = new ulong[Math.Max(16, core / 64 + 1)];
+                mask[core / 64] = 1UL << (core % 64);
+                return sched_setaffinity(0, new IntPtr(mask.Length * 8), mask) == 0;
+            }
+            catch (DllNotFoundException)
+            {
+                return false;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                return false;
+            }
+        }
+
+        [DllImport("kernel32.dll")]
+        private static extern IntPtr GetCurrentThread();
+
+        [DllImport("kernel32.dll")]
+        private static extern UIntPtr SetThreadAffinityMask(IntPtr thread, UIntPtr mask);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int sched_setaffinity(int pid, IntPtr size, ulong[] mask);
+    }
+}
@@ -0,0 +1,218 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+using YEISensorLib.Sharped.Streaming;
+
+namespace YEISensorLib.Sharped.Wireless
+{
+    /// <summary>
+    /// Spreads wireless sensors over several dongles so each carries about the same packet rate.
+    /// 
+    /// Measure reads every dongle's logical id table and open slots and counts the packets of the running streams.
+    /// Plan moves sensors from the busiest dongle to the least busy one while that narrows the gap, going by the rate
+    /// the streams ask for: the delivered rate of a saturated dongle is capped and would hide how overloaded it is.
+    /// Apply rewrites and commits the tables. A moved sensor is retuned to its new dongle's pan id and channel first,
+    /// its streams are stopped and must be opened again from the new dongle, at DongleMove.ToLogicalId.
+    /// 
+    /// Usage:
+    ///     var balancer = new DongleBalancer(dongles);
+    ///     var before = balancer.Measure(streams, TimeSpan.FromSeconds(5));
+    ///     var moves = balancer.Apply(balancer.Plan(before), streams);
+    /// </summary>
+    public class DongleBalancer
+    {
+        public IList<WirelessDongle> Dongles { get; private set; }
+
+        /// <summary>
+        /// Spread between the busiest and least busy dongle, as a fraction of the mean, left alone. Default 5%.
+        /// </summary>
+        public double Tolerance { get; set; }
+
+        public DongleBalancer(IEnumerable<WirelessDongle> dongles)
+        {
+            Dongles = dongles.ToList();
+            Tolerance = 0.05;
+        }
+
+        /// <summary>
+        /// Refreshes the dongles and measures the streams for a while.
+        /// </summary>
+        /// <param name="streams">Streams of the paired sensors, matched to the dongles by serial number.</param>
+        /// <param name="window">How long to count packets.</param>
+        /// <returns>The load of every dongle that could be read.</returns>
+        public IList<DongleLoad> Measure(IEnumerable<SensorStream> streams, TimeSpan window)
+        {
+            var dongles = Dongles.Where(d => d.Refresh()).ToArray();
+            var active = streams.Where(s => s.IsStreaming).ToArray();
+
+            var counts = active.Select(s => s.PacketsReceived).ToArray();
+            var stopwatch = Stopwatch.StartNew();
+            Thread.Sleep(window);
+            var seconds = stopwatch.Elapsed.TotalSeconds;
+
+            var requested = new Dictionary<uint, double>();
+            var delivered = new Dictionary<uint, double>();
+            for (var i = 0; i < active.Length; i++)
+            {
+                var serialNumber = active[i].Device.SerialNumberValue;
+                double rate;
+                requested.TryGetValue(serialNumber, out rate);
+                requested[serialNumber] = rate + 1000000.0 / Math.Max(1, active[i].IntervalMicroseconds);
+                delivered.TryGetValue(serialNumber, out rate);
+                delivered[serialNumber] = rate + (active[i].PacketsReceived - counts[i]) / seconds;
+            }
+
+            var loads = new List<DongleLoad>();
+            foreach (var dongle in dongles)
+            {
+                var sensors = new Dictionary<uint, double>();
+                var dongleDelivered = 0.0;
+                foreach (var serialNumber in dongle.Pairings.Where(s => s != 0))
+                {
+                    double rate;
+                    sensors[serialNumber] = requested.TryGetValue(serialNumber, out rate) ? rate : 0;
+                    if (delivered.TryGetValue(serialNumber, out rate)) dongleDelivered += rate;
+                }
+                loads.Add(new DongleLoad(dongle, sensors, dongleDelivered, dongle.FreeLogicalIds, dongle.SlotsOpen));
+            }
+            return loads;
+        }
+
+        /// <summary>
+        /// Chooses which sensors to move, without touching the dongles. Each sensor moves at most once and only to a
+        /// dongle with a free logical id and an open slot.
+        /// </summary>
+        public IList<DongleMove> Plan(IList<DongleLoad> loads)
+        {
+            var moves = new List<DongleMove>();
+            if (loads.Count < 2) return moves;
+
+            var rates = loads.Select(l => l.RequestedPacketsPerSecond).ToArray();
+            var slots = loads.Select(l => l.SlotsOpen).ToArray();
+            var tables = loads.Select(l => l.Dongle.Pairings.ToArray()).ToArray();
+            var sensors = loads.Select(l => new Dictionary<uint, double>(l.Sensors)).ToArray();
+            var tolerance = Tolerance * rates.Average();
+
+            while (true)
+            {
+                var from = Array.IndexOf(rates, rates.Max());
+                DongleMove move = null;
+                foreach (var to in Enumerable.Range(0, loads.Count).OrderBy(i => rates[i]))
+                {
+                    var gap = rates[from] - rates[to];
+                    if (gap <= tolerance) break;
+
+                    var freeId = Array.IndexOf(tables[to], 0u);
+                    if (freeId < 0 || slots[to] <= 0) continue;
+
+                    //The sensor bringing both closest to the middle, only ones that narrow the gap.
+                    var best = sensors[from].Where(s => s.Value > 0 && s.Value < gap)
+                                            .OrderBy(s => Math.Abs(gap / 2 - s.Value))
+                                            .Select(s => (KeyValuePair<uint, double>?)s)
+                                            .FirstOrDefault();
+                    if (best == null) continue;
+
+                    var serialNumber = best.Value.Key;
+                    var rate = best.Value.Value;
+                    var fromId = Array.IndexOf(tables[from], serialNumber);
+                    move = new DongleMove(serialNumber, loads[from].Dongle, fromId, loads[to].Dongle, freeId, rate);
+
+                    sensors[from].Remove(serialNumber);
+                    tables[from][fromId] = 0;
+                    tables[to][freeId] = serialNumber;
+                    rates[from] -= rate;
+                    rates[to] += rate;
+                    slots[from]++;
+                    slots[to]--;
+                    break;
+                }
+                if (move == null) return moves;
+                moves.Add(move);
+            }
+        }
+
+        /// <summary>
+        /// Re-pairs the sensors one move at a time, committing both dongles after each. Streams of moved sensors are
+        /// stopped, those of moves that fail are started again.
+        /// A move fails if its sensor cannot be retuned or a table write or commit fails, the sensor is then put back.
+        /// Later moves are checked against the tables as they are: a move whose sensor is no longer at its old id is
+        /// dropped, one whose new id is taken gets another free id or is dropped.
+        /// </summary>
+        /// <param name="moves">From Plan.</param>
+        /// <param name="streams">Streams of the paired sensors.</param>
+        /// <returns>The moves written to the dongles.</returns>
+        public IList<DongleMove> Apply(IList<DongleMove> moves, IEnumerable<SensorStream> streams)
+        {
+            var streamList = streams.ToList();
+            var applied = new List<DongleMove>();
+            foreach (var planned in moves)
+            {
+                if (planned.From.Pairings[planned.FromLogicalId] != planned.SerialNumber) continue;
+                var toId = planned.To.Pairings[planned.ToLogicalId] == 0 ? planned.ToLogicalId : planned.To.Pairings.IndexOf(0);
+                if (toId < 0) continue;
+                var move = new DongleMove(planned.SerialNumber, planned.From, planned.FromLogicalId, planned.To, toId, planned.PacketsPerSecond);
+
+                var sensorStreams = streamList.Where(s => s.Device.SerialNumberValue == move.SerialNumber && s.IsStreaming).ToArray();
+                var polled = sensorStreams.Select(s => s.IsPolled).ToArray();
+                foreach (var stream in sensorStreams) stream.Stop();
+
+                if (Move(move)) applied.Add(move);
+                else
+                {
+                    for (var i = 0; i < sensorStreams.Length; i++)
+                    {
+                        if (polled[i]) sensorStreams[i].StartPolled();
+                        else sensorStreams[i].Start();
+                    }
+                }
+            }
+            return applied;
+        }
+
+        private static bool Move(DongleMove move)
+        {
+            var retune = move.From.PanId != move.To.PanId || move.From.Channel != move.To.Channel;
+            uint sensorId = Defines.NO_DEVICE_ID;
+            if (retune)
+            {
+                //The API hands out the id it already has for the sensor, it may be in use elsewhere: never close it here.
+                if (ThreeSpaceInterop.GetSensorFromDongle(move.From.Device.DeviceId, move.FromLogicalId, out sensorId) != ResultEnum.NoError
+                    || sensorId == Defines.NO_DEVICE_ID) return false;
+                if (!Retune(sensorId, move.To.PanId, move.To.Channel))
+                {
+                    Retune(sensorId, move.From.PanId, move.From.Channel);
+                    return false;
+                }
+            }
+
+            if (move.From.SetPairing(move.FromLogicalId, 0))
+            {
+                if (move.To.SetPairing(move.ToLogicalId, move.SerialNumber))
+                {
+                    if (move.From.Commit() && move.To.Commit()) return true;
+                    move.To.SetPairing(move.ToLogicalId, 0);
+                }
+                move.From.SetPairing(move.FromLogicalId, move.SerialNumber);
+                move.From.Commit();
+                move.To.Commit();
+            }
+
+            //Over the air the sensor may no longer hear its old dongle, so this is best effort.
+            if (retune) Retune(sensorId, move.From.PanId, move.From.Channel);
+            return false;
+        }
+
+        private static bool Retune(uint sensorId, ushort panId, byte channel)
+        {
+            uint timeStamp;
+            return ThreeSpaceInterop.SetWirelessPanId(sensorId, panId, out timeStamp) == ResultEnum.NoError
+                   && ThreeSpaceInterop.SetWirelessChannel(sensorId, channel, out timeStamp) == ResultEnum.NoError
+                   && ThreeSpaceInterop.CommitWirelessSettings(sensorId, out timeStamp) == ResultEnum.NoError;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Wireless
+{
+    /// <summary>
+    /// The stream load of one dongle, as measured by DongleBalancer.Measure.
+    /// </summary>
+    public class DongleLoad
+    {
+        public WirelessDongle Dongle { get; private set; }
+
+        /// <summary>
+        /// Packets per second each paired sensor's streams ask for, by serial number.
+        /// </summary>
+        public IDictionary<uint, double> Sensors { get; private set; }
+
+        /// <summary>
+        /// Packets per second the sensors' streams asked for.
+        /// </summary>
+        public double RequestedPacketsPerSecond { get { return Sensors.Values.Sum(); } }
+
+        /// <summary>
+        /// Packets per second the sensors' streams received. Below the requested rate when the dongle saturates.
+        /// </summary>
+        public double DeliveredPacketsPerSecond { get; private set; }
+
+        public int FreeLogicalIds { get; private set; }
+
+        public int SlotsOpen { get; private set; }
+
+        public DongleLoad(WirelessDongle dongle, IDictionary<uint, double> sensors, double deliveredPacketsPerSecond, int freeLogicalIds, int slotsOpen)
+        {
+            Dongle = dongle;
+            Sensors = sensors;
+            DeliveredPacketsPerSecond = deliveredPacketsPerSecond;
+            FreeLogicalIds = freeLogicalIds;
+            SlotsOpen = slotsOpen;
+        }
+    }
+}
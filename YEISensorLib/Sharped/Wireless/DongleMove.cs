@@ -0,0 +1,45 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace YEISensorLib.Sharped.Wireless
+{
+    /// <summary>
+    /// One sensor re-paired from one dongle to another.
+    /// </summary>
+    public class DongleMove
+    {
+        public uint SerialNumber { get; private set; }
+
+        public WirelessDongle From { get; private set; }
+
+        public int FromLogicalId { get; private set; }
+
+        public WirelessDongle To { get; private set; }
+
+        public int ToLogicalId { get; private set; }
+
+        /// <summary>
+        /// The sensor's requested packets per second, moved with it.
+        /// </summary>
+        public double PacketsPerSecond { get; private set; }
+
+        public DongleMove(uint serialNumber, WirelessDongle from, int fromLogicalId, WirelessDongle to, int toLogicalId, double packetsPerSecond)
+        {
+            SerialNumber = serialNumber;
+            From = from;
+            FromLogicalId = fromLogicalId;
+            To = to;
+            ToLogicalId = toLogicalId;
+            PacketsPerSecond = packetsPerSecond;
+        }
+
+        public override string ToString()
+        {
+            return string.Format("{0:X8}: {1:X8}#{2} -> {3:X8}#{4} ({5:0} pkt/s)", SerialNumber,
+                                 From.Device.SerialNumberValue, FromLogicalId, To.Device.SerialNumberValue, ToLogicalId, PacketsPerSecond);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using YEISensorLib.RawApi;
+
+namespace YEISensorLib.Sharped.Wireless
+{
+    /// <summary>
+    /// A dongle's wireless settings and logical id table: which sensor serial is paired at each id.
+    /// Refresh reads them, SetPairing changes the table and Commit applies it.
+    /// </summary>
+    public class WirelessDongle
+    {
+        /// <summary>
+        /// Logical ids per dongle, 0-14.
+        /// </summary>
+        public const int LogicalIdCount = 15;
+
+        private readonly uint[] _pairings = new uint[LogicalIdCount];
+
+        public SensorDevice Device { get; private set; }
+
+        /// <summary>
+        /// Serial number paired at each logical id, 0 where the id is free.
+        /// </summary>
+        public IList<uint> Pairings { get { return _pairings; } }
+
+        public int SlotsOpen { get; private set; }
+
+        public ushort PanId { get; private set; }
+
+        public byte Channel { get; private set; }
+
+        /// <summary>
+        /// Number of logical ids without a sensor.
+        /// </summary>
+        public int FreeLogicalIds { get { return _pairings.Count(s => s == 0); } }
+
+        public WirelessDongle(SensorDevice device)
+        {
+            if (!device.IsDongle) throw new ArgumentOutOfRangeException("device", "The device is not a dongle.");
+            Device = device;
+        }
+
+        /// <summary>
+        /// Reads the logical id table, open slots, pan id and channel.
+        /// </summary>
+        public bool Refresh()
+        {
+            if (!Device.IsConnected) return false;
+            uint timeStamp;
+            for (var id = 0; id < LogicalIdCount; id++)
+            {
+                uint serialNumber;
+                if (ThreeSpaceInterop.GetSerialNumberAtLogicalId(Device.DeviceId, (byte)id, out serialNumber, out timeStamp) != ResultEnum.NoError) return false;
+                _pairings[id] = serialNumber;
+            }
+
+            byte slotsOpen;
+            ushort panId;
+            byte channel;
+            if (ThreeSpaceInterop.GetWirelessSlotsOpen(Device.DeviceId, out slotsOpen, out timeStamp) != ResultEnum.NoError) return false;
+            if (ThreeSpaceInterop.GetWirelessPanId(Device.DeviceId, out panId, out timeStamp) != ResultEnum.NoError) return false;
+            if (ThreeSpaceInterop.GetWirelessChannel(Device.DeviceId, out channel, out timeStamp) != ResultEnum.NoError) return false;
+            SlotsOpen = slotsOpen;
+            PanId = panId;
+            Channel = channel;
+            return true;
+        }
+
+        /// <summary>
+        /// Logical id of the sensor, or -1 if it is not paired with this dongle.
+        /// </summary>
+        public int LogicalIdOf(uint serialNumber)
+        {
+            return serialNumber == 0 ? -1 : Array.IndexOf(_pairings, serialNumber);
+        }
+
+        /// <summary>
+        /// Pairs a sensor at a logical id, 0 frees the id. Takes effect on Commit.
+        /// </summary>
+        public bool SetPairing(int logicalId, uint serialNumber)
+        {
+            if (logicalId < 0 || logicalId >= LogicalIdCount) throw new ArgumentOutOfRangeException("logicalId");
+            if (!Device.IsConnected) return false;
+            uint timeStamp;
+            if (ThreeSpaceInterop.SetSerialNumberAtLogicalId(Device.DeviceId, (byte)logicalId, serialNumber, out timeStamp) != ResultEnum.NoError) return false;
+            _pairings[logicalId] = serialNumber;
+            return true;
+        }
+
+        /// <summary>
+        /// Saves and applies the logical id table.
+        /// </summary>
+        public bool Commit()
+        {
+            if (!Device.IsConnected) return false;
+            uint timeStamp;
+            return ThreeSpaceInterop.CommitWirelessSettings(Device.DeviceId, out timeStamp) == ResultEnum.NoError;
+        }
+
+        /// <summary>
+        /// Opens the sensor at a logical id, see SensorDevice.FromDongle.
+        /// </summary>
+        public SensorDevice OpenSensor(int logicalId)
+        {
+            return SensorDevice.FromDongle(Device, logicalId);
+        }
+    }
+}